@@ -44,6 +44,14 @@ namespace caf
 	Comment("Factor by which to prescale unblind events"), 10
     };
 
+    Atom<bool> AsyncWrite { Name("AsyncWrite"),
+      Comment("Fill the output trees from a separate thread, so that compressing and writing a record overlaps with making the next one"), false
+    };
+
+    Atom<unsigned> WriteQueueSize { Name("WriteQueueSize"),
+      Comment("With AsyncWrite, the number of completed records that can wait to be written before the event loop blocks"), 2
+    };
+
     Atom<int> POTBlindSeed { Name("POTBlindNum"),
 	Comment("Integer used to derive POT scaling factor for blind events"), 655277
     };
@@ -19,6 +19,7 @@
 #include "sbncode/CAFMaker/FillReco.h"
 #include "sbncode/CAFMaker/FillExposure.h"
 #include "sbncode/CAFMaker/FillTrigger.h"
+#include "sbncode/CAFMaker/RecordWriter.h"
 #include "sbncode/CAFMaker/Utils.h"
 
 // C/C++ includes
@@ -49,6 +50,7 @@
 #include "TTimeStamp.h"
 #include "TRandomGen.h"
 #include "TObjString.h"
+#include "TROOT.h"
 
 // Framework includes
 #include "art/Framework/Core/EDProducer.h"
@@ -214,6 +216,29 @@ class CAFMaker : public art::EDProducer {
   flat::Flat<caf::StandardRecord>* fFlatRecordb = 0;
   flat::Flat<caf::StandardRecord>* fFlatRecordp = 0;
 
+  /// Fields overwritten by BlindEnergyParameters and their original values,
+  /// so the blinded stream can be written from the event record in place
+  std::vector<std::pair<float*, float>> fBlindedFields;
+
+  /// How a record goes into the blinded and prescaled files
+  struct BlindStream {
+    bool active = false;   ///< blinded files are being made
+    bool prescale = false; ///< to the prescaled file, otherwise to the blinded one
+    SRHeader hdr;          ///< header of the record in that file
+  };
+
+  /// A completed record waiting for the writer thread
+  struct PendingRecord {
+    StandardRecord rec;
+    BlindStream stream;
+  };
+
+  /// Writes the records from a separate thread if AsyncWrite is set. Only
+  /// that thread touches the record trees while records are pending
+  std::unique_ptr<RecordWriter<PendingRecord>> fWriter;
+  /// Writer failure caught in produce (noexcept), rethrown by FlushWriter
+  std::exception_ptr fWriterError;
+
   Det_t fDet;  ///< Detector ID in caf namespace typedef
 
   // volumes
@@ -243,6 +268,11 @@ class CAFMaker : public art::EDProducer {
   void InitializeOutfiles();
 
   void BlindEnergyParameters(StandardRecord* brec);
+  void UnblindEnergyParameters();
+  /// Fill the record into the output trees
+  void WriteRecord(StandardRecord& rec, BlindStream& stream);
+  /// Wait for the pending records, reporting a writer failure as a cet::exception
+  void FlushWriter();
   double GetBlindPOTScale() const;
 
   void InitVolumes(); ///< Initialize volumes from Gemotry service
@@ -359,6 +389,12 @@ class CAFMaker : public art::EDProducer {
 //......................................................................
 void CAFMaker::BlindEnergyParameters(StandardRecord* brec) {
 
+  // blind a field, remembering its value for UnblindEnergyParameters
+  auto blind = [this](float& f) {
+    fBlindedFields.emplace_back(&f, f);
+    f = TMath::QuietNaN();
+  };
+
   //simple cuts for trk and shower variables
   //blind events with a potential lepton with momentum > 0.6 that starts in fiducial volume
   for (caf::SRPFP& pfp: brec->reco.pfp) {
@@ -369,10 +405,10 @@ void CAFMaker::BlindEnergyParameters(StandardRecord* brec) {
 	 (start.z  > -895.95 + 30 && start.z < 895.95 - 50)) {
 
       if (pfp.trk.mcsP.fwdP_muon > 0.6) {
-	pfp.trk.mcsP.fwdP_muon = TMath::QuietNaN();    
+	blind(pfp.trk.mcsP.fwdP_muon);    
       }
       if (pfp.trk.rangeP.p_muon > 0.6) {
-	pfp.trk.rangeP.p_muon = TMath::QuietNaN();
+	blind(pfp.trk.rangeP.p_muon);
       }
     }
   }
@@ -385,10 +421,10 @@ void CAFMaker::BlindEnergyParameters(StandardRecord* brec) {
 	 (start.y > -181.7 + 25 && start.y < 134.8 - 25 ) &&
 	 (start.z  > -895.95 + 30 && start.z < 895.95 - 50)) {
       if (pfp.shw.bestplane_energy > 0.6) {
-	pfp.shw.bestplane_energy = TMath::QuietNaN();
-	pfp.shw.plane[0].energy = TMath::QuietNaN();
-	pfp.shw.plane[1].energy = TMath::QuietNaN();
-	pfp.shw.plane[2].energy = TMath::QuietNaN();
+	blind(pfp.shw.bestplane_energy);
+	blind(pfp.shw.plane[0].energy);
+	blind(pfp.shw.plane[1].energy);
+	blind(pfp.shw.plane[2].energy);
       }
     }
   }
@@ -403,24 +439,32 @@ void CAFMaker::BlindEnergyParameters(StandardRecord* brec) {
 
       for (caf::SRPFP& pfp: slc.reco.pfp) {
 	if (pfp.trk.mcsP.fwdP_muon > 0.6) {
-	  pfp.trk.mcsP.fwdP_muon = TMath::QuietNaN();    
+	  blind(pfp.trk.mcsP.fwdP_muon);    
 	}
 	if (pfp.trk.rangeP.p_muon > 0.6) {
-	  pfp.trk.rangeP.p_muon = TMath::QuietNaN();
+	  blind(pfp.trk.rangeP.p_muon);
 	}
       }
       for (caf::SRPFP& pfp: slc.reco.pfp) {
 	if (pfp.shw.bestplane_energy > 0.6) {
-	  pfp.shw.bestplane_energy = TMath::QuietNaN();
-	  pfp.shw.plane[0].energy = TMath::QuietNaN();
-	  pfp.shw.plane[1].energy = TMath::QuietNaN();
-	  pfp.shw.plane[2].energy = TMath::QuietNaN();
+	  blind(pfp.shw.bestplane_energy);
+	  blind(pfp.shw.plane[0].energy);
+	  blind(pfp.shw.plane[1].energy);
+	  blind(pfp.shw.plane[2].energy);
 	}
       }
     }
   }
 }
 
+void CAFMaker::UnblindEnergyParameters() {
+  // restore in reverse order, in case a field was blinded twice
+  for (auto it = fBlindedFields.rbegin(); it != fBlindedFields.rend(); ++it) {
+    *it->first = it->second;
+  }
+  fBlindedFields.clear();
+}
+
 void CAFMaker::FixPMTReferenceTimes(StandardRecord &rec, double PMT_reference_time) {
   // Fix the flashes
   for (SROpFlash &f: rec.opflashes) {
@@ -502,6 +546,9 @@ void CAFMaker::InitVolumes() {
 //......................................................................
 CAFMaker::~CAFMaker()
 {
+  // write out whatever is pending before the trees go away
+  fWriter.reset();
+
   delete fRecTree;
   delete fFile;
 
@@ -602,6 +649,45 @@ void CAFMaker::respondToOpenInputFile(const art::FileBlock& fb) {
 //......................................................................
 void CAFMaker::beginJob()
 {
+  if (fParams.AsyncWrite()) {
+    // the output trees are filled from the writer thread while this one
+    // keeps using ROOT, which needs ROOT's internal locks turned on
+    ROOT::EnableThreadSafety();
+    fWriter = std::make_unique<RecordWriter<PendingRecord>>(
+      [this](PendingRecord& pending) { WriteRecord(pending.rec, pending.stream); },
+      fParams.WriteQueueSize());
+  }
+}
+
+//......................................................................
+void CAFMaker::FlushWriter()
+{
+  if (!fWriter) return;
+
+  std::exception_ptr error = fWriterError;
+  fWriterError = nullptr;
+  if (!error) {
+    try {
+      fWriter->Flush();
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+  }
+  if (!error) return;
+
+  try {
+    std::rethrow_exception(error);
+  }
+  catch (cet::exception const& e) {
+    throw cet::exception("CAFMaker", "Writing the CAF records failed\n", e);
+  }
+  catch (std::exception const& e) {
+    throw cet::exception("CAFMaker") << "Writing the CAF records failed: " << e.what() << "\n";
+  }
+  catch (...) {
+    throw cet::exception("CAFMaker") << "Writing the CAF records failed\n";
+  }
 }
 
 //......................................................................
@@ -711,6 +797,9 @@ void CAFMaker::beginRun(art::Run& run) {
     } // end for pset
   } // end for label
 
+  // the files are written from this thread below
+  FlushWriter();
+
   if(fFile) AddGlobalTreeToFile(fFile, global);
   if(fParams.CreateBlindedCAF() && fFileb) AddGlobalTreeToFile(fFileb, global);
   if(fParams.CreateBlindedCAF() && fFilep) AddGlobalTreeToFile(fFilep, global);
@@ -1183,6 +1272,13 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     }
   }
 
+  // Lookup tables for the truth matching below. Holds pointers into
+  // true_particles, which is not modified from here on
+  std::vector<art::Ptr<sim::SimChannel>> bt_simchannels;
+  if ( !isRealData ) bt_simchannels = art::ServiceHandle<cheat::BackTrackerService>()->SimChannels();
+  caf::TruthIndex truth_index(mc_particles.isValid() ? mc_particles.product() : nullptr,
+                              &true_particles, &id_to_ide_map, bt_simchannels, geometry);
+
   std::vector<art::FindManyP<sbn::evwgh::EventWeightMap>> fmpewm;
 
   // holder for invalid MCFlux
@@ -1201,7 +1297,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
     srtruthbranch.nu.push_back(SRTrueInteraction());
     srtruthbranch.nnu ++;
 
-    if ( !isRealData ) FillTrueNeutrino(mctruth, mcflux, gtruth, true_particles, id_to_truehit_map, srtruthbranch.nu.back(), i, fActiveVolumes);
+    if ( !isRealData ) FillTrueNeutrino(mctruth, mcflux, gtruth, truth_index, id_to_truehit_map, srtruthbranch.nu.back(), i, fActiveVolumes);
 
     // Don't check for syst weight assocations until we have something (MCTruth
     // corresponding to a neutrino) that could plausibly be reweighted. This
@@ -1634,7 +1730,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
       rec.reco.stub.emplace_back();
       FillStubVars(thisStub, thisStubPFP, rec.reco.stub.back());
-      if ( !isRealData ) FillStubTruth(fmStubHits.at(iStub), id_to_hit_energy_map, true_particles, clock_data, rec.reco.stub.back());
+      if ( !isRealData ) FillStubTruth(fmStubHits.at(iStub), id_to_hit_energy_map, truth_index, clock_data, rec.reco.stub.back());
       rec.reco.nstub = rec.reco.stub.size();
 
       // Duplicate stub reco info in the srslice
@@ -1758,10 +1854,10 @@ void CAFMaker::produce(art::Event& evt) noexcept {
         if (fmTrackHit.isValid()) {
           if ( !isRealData ) {
             // Track -> particle matching
-            FillTrackTruth(fmTrackHit.at(iPart), id_to_hit_energy_map, true_particles, clock_data, trk);
+            FillTrackTruth(fmTrackHit.at(iPart), id_to_hit_energy_map, truth_index, clock_data, trk);
             // Hit truth information corresponding to Calo-Points
             // Assumes truth matching and calo-points are filled
-            if (mc_particles.isValid() && fParams.FillTrackCaloTruth()) FillTrackCaloTruth(id_to_ide_map, *mc_particles, geometry, clock_data, sce, trk);
+            if (mc_particles.isValid() && fParams.FillTrackCaloTruth()) FillTrackCaloTruth(truth_index, geometry, clock_data, sce, trk);
           }
         }
       } // thisTrack exists
@@ -1789,7 +1885,7 @@ void CAFMaker::produce(art::Event& evt) noexcept {
           FillShowerDensityFit(*fmShowerDensityFit.at(iPart).front(), shw);
         }
         if (fmShowerHit.isValid()) {
-          if ( !isRealData ) FillShowerTruth(fmShowerHit.at(iPart), id_to_hit_energy_map, true_particles, clock_data, shw);
+          if ( !isRealData ) FillShowerTruth(fmShowerHit.at(iPart), id_to_hit_energy_map, truth_index, clock_data, shw);
         }
 
       } // thisShower exists
@@ -1903,79 +1999,121 @@ void CAFMaker::produce(art::Event& evt) noexcept {
 
 
   if(fRecTree){
-    // Save the standard-record
-    StandardRecord* prec = &rec;
-    fRecTree->SetBranchAddress("rec", &prec);
-    fRecTree->Fill();
-
-    if(fFlatTree){
-      fFlatRecord->Clear();
-      fFlatRecord->Fill(rec);
-      fFlatTree->Fill();
-    }
-
     //Generate random number to decide if event is saved in prescale or blinded file
+    BlindStream stream;
     if (fParams.CreateBlindedCAF()) {
       const bool keepprescale = fBlindTRandom->Uniform() < 1/fParams.PrescaleFactor();
-      rec.hdr.evt = 0;
-      rec.hdr.isblind = true;
+      stream.active = true;
+      stream.prescale = keepprescale;
+      stream.hdr = rec.hdr;
+      stream.hdr.isblind = true;
       if (keepprescale) {
-      	StandardRecord* precp = new StandardRecord (*prec);
 	if (fFirstPrescaleInFile) {
-	  precp->hdr.pot = fSubRunPOT*(1/fParams.PrescaleFactor());
-	  precp->hdr.first_in_file = true;
-	  precp->hdr.first_in_subrun = true;
-	  precp->hdr.nbnbinfo = fBNBInfo.size()*(1/fParams.PrescaleFactor());
-	  precp->hdr.nnumiinfo = fNuMIInfo.size()*(1/fParams.PrescaleFactor());
+	  stream.hdr.pot = fSubRunPOT*(1/fParams.PrescaleFactor());
+	  stream.hdr.first_in_file = true;
+	  stream.hdr.first_in_subrun = true;
+	  stream.hdr.nbnbinfo = fBNBInfo.size()*(1/fParams.PrescaleFactor());
+	  stream.hdr.nnumiinfo = fNuMIInfo.size()*(1/fParams.PrescaleFactor());
 	}
-	precp->hdr.ngenevt = n_gen_evt*(1/fParams.PrescaleFactor());
-	precp->hdr.evt = evtID;
-	fRecTreep->SetBranchAddress("rec", &precp);
-      	fRecTreep->Fill();
+	stream.hdr.ngenevt = n_gen_evt*(1/fParams.PrescaleFactor());
 	fPrescaleEvents += 1;
-	if (fFlatTreep) {
-	  fFlatRecordp->Clear();
-	  fFlatRecordp->Fill(*precp);
-	  fFlatTreep->Fill();
-	}
 	fFirstPrescaleInFile = false;
       }
       else {
-	StandardRecord* precb = new StandardRecord (*prec);
-	BlindEnergyParameters(precb);
 	if (fFirstBlindInFile) {
-	  precb->hdr.pot = fSubRunPOT*(1-(1/fParams.PrescaleFactor()))*GetBlindPOTScale();
-	  precb->hdr.first_in_file = true;
-	  precb->hdr.first_in_subrun = true;
-	  precb->hdr.nbnbinfo = fBNBInfo.size()*(1 - (1/fParams.PrescaleFactor()));
-	  precb->hdr.nnumiinfo = fNuMIInfo.size()*(1-(1/fParams.PrescaleFactor()));
+	  stream.hdr.pot = fSubRunPOT*(1-(1/fParams.PrescaleFactor()))*GetBlindPOTScale();
+	  stream.hdr.first_in_file = true;
+	  stream.hdr.first_in_subrun = true;
+	  stream.hdr.nbnbinfo = fBNBInfo.size()*(1 - (1/fParams.PrescaleFactor()));
+	  stream.hdr.nnumiinfo = fNuMIInfo.size()*(1-(1/fParams.PrescaleFactor()));
 	}
-	precb->hdr.ngenevt = n_gen_evt*(1 - (1/fParams.PrescaleFactor()));
-	precb->hdr.evt = evtID;
-	fRecTreeb->SetBranchAddress("rec", &precb);
-	fRecTreeb->Fill();
+	stream.hdr.ngenevt = n_gen_evt*(1 - (1/fParams.PrescaleFactor()));
 	fBlindEvents += 1;
-	if (fFlatTreeb) {
-	  fFlatRecordb->Clear();
-	  fFlatRecordb->Fill(*precb);
-	  fFlatTreeb->Fill();
-	}
 	fFirstBlindInFile = false;
       }
+      stream.hdr.evt = evtID;
+    }
+
+    if (fWriter) {
+      // the writer thread gets its own copy, the event product keeps rec.
+      // produce cannot throw: a failure is kept for FlushWriter, and no more
+      // records are queued after it
+      if (!fWriterError) {
+        std::unique_ptr<PendingRecord> pending = std::make_unique<PendingRecord>();
+        pending->rec = rec;
+        pending->stream = std::move(stream);
+        try {
+          fWriter->Submit(std::move(pending));
+        }
+        catch (...) {
+          fWriterError = std::current_exception();
+        }
+      }
+    }
+    else {
+      WriteRecord(rec, stream);
+    }
+
+    if (fParams.CreateBlindedCAF()) {
+      rec.hdr.evt = 0;
+      rec.hdr.isblind = true;
     }
   }
 
 // reset
   fFirstInFile = false;
   fFirstInSubRun = false;
-  srcol->push_back(rec);
+  srcol->push_back(std::move(rec));
   evt.put(std::move(srcol));
 
   fBNBInfo.clear();
   fNuMIInfo.clear();
-  rec.hdr.pot = 0;
 }
 
+//......................................................................
+void CAFMaker::WriteRecord(StandardRecord& rec, BlindStream& stream) {
+
+  // Save the standard-record
+  StandardRecord* prec = &rec;
+  fRecTree->SetBranchAddress("rec", &prec);
+  fRecTree->Fill();
+
+  if(fFlatTree){
+    fFlatRecord->Clear();
+    fFlatRecord->Fill(rec);
+    fFlatTree->Fill();
+  }
+
+  if (!stream.active) return;
+
+  // The prescaled or blinded record is the event record with its header
+  // swapped for the stream one and, when blinded, a few fields overwritten.
+  // All of it is put back once the record has been written
+  std::swap(rec.hdr, stream.hdr);
+  if (stream.prescale) {
+    fRecTreep->SetBranchAddress("rec", &prec);
+    fRecTreep->Fill();
+    if (fFlatTreep) {
+      fFlatRecordp->Clear();
+      fFlatRecordp->Fill(rec);
+      fFlatTreep->Fill();
+    }
+  }
+  else {
+    BlindEnergyParameters(prec);
+    fRecTreeb->SetBranchAddress("rec", &prec);
+    fRecTreeb->Fill();
+    if (fFlatTreeb) {
+      fFlatRecordb->Clear();
+      fFlatRecordb->Fill(rec);
+      fFlatTreeb->Fill();
+    }
+    UnblindEnergyParameters();
+  }
+  std::swap(rec.hdr, stream.hdr);
+}
+
+//......................................................................
 void CAFMaker::endSubRun(art::SubRun& sr) {
 
 }
@@ -2025,6 +2163,8 @@ void CAFMaker::endJob() {
     return;
   }
 
+  // every record has to be in the trees before they are written
+  FlushWriter();
 
 
   if(fFile){
@@ -10,7 +10,7 @@
 
 // helper function declarations
 
-caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const std::vector<caf::SRTrueParticle> &particles, const std::vector<art::Ptr<recob::Hit>> &hits,
+caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const caf::TruthIndex &truth_index, const std::vector<art::Ptr<recob::Hit>> &hits,
 				   const std::map<int, caf::HitsEnergy> &all_hits_map);
 
 caf::SRTruthMatch MatchSlice2Truth(const std::vector<art::Ptr<recob::Hit>> &hits,
@@ -119,54 +119,39 @@ namespace caf {
 
   void FillTrackTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                       const std::map<int, caf::HitsEnergy> &id_hits_map,
-                      const std::vector<caf::SRTrueParticle> &particles,
+                      const caf::TruthIndex &truth_index,
                       const detinfo::DetectorClocksData &clockData,
                       caf::SRTrack& srtrack,
                       bool allowEmpty)
   {
     // Truth matching
-    srtrack.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srtrack.truth = MatchTrack2Truth(clockData, truth_index, hits, id_hits_map);
 
   }//FillTrackTruth
 
   // Assumes truth matching and calo-points are filled
-  void FillTrackCaloTruth(const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> &id_to_ide_map,
-                          const std::vector<simb::MCParticle> &mc_particles,
+  void FillTrackCaloTruth(caf::TruthIndex &truth_index,
                           const geo::GeometryCore *geo,
                           const detinfo::DetectorClocksData &clockData,
                           const spacecharge::SpaceCharge *sce,
                           caf::SRTrack& srtrack) {
 
-    art::ServiceHandle<cheat::BackTrackerService> bt_serv;
-
     // require track to be truth matched
     if (srtrack.truth.p.G4ID < 0) return;
-    if (!id_to_ide_map.count(srtrack.truth.p.G4ID)) return;
+
+    // Load the hits, by channel
+    const std::map<unsigned, std::vector<const sim::IDE *>> *match_ides = truth_index.ChannelIDEs(srtrack.truth.p.G4ID);
+    if (!match_ides) return;
+    const std::map<unsigned, std::vector<const sim::IDE *>> &chan_2_ides = *match_ides;
 
     // Look up the true particle trajectory
-    const simb::MCParticle *match = NULL;
-    for (const simb::MCParticle &p: mc_particles) {
-      if (p.TrackId() == srtrack.truth.p.G4ID) {
-        match = &p;
-        break;
-      }
-    }
+    const simb::MCParticle *match = truth_index.Particle(srtrack.truth.p.G4ID);
     if (!match) return;
     const simb::MCParticle &particle = *match;
 
-    // Load the hits
-    // match on the channel, which is unique
-    const std::vector<std::pair<geo::WireID, const sim::IDE*>> &match_ides = id_to_ide_map.at(srtrack.truth.p.G4ID);
-    std::map<unsigned, std::vector<const sim::IDE *>> chan_2_ides;
-    for (auto const &ide_pair: match_ides) {
-      chan_2_ides[geo->PlaneWireToChannel(ide_pair.first)].push_back(ide_pair.second);
-    }
-
-    // pre-compute partial ranges
-    std::vector<double> partial_ranges(particle.NumberTrajectoryPoints(), 0);
-    for (int i = particle.NumberTrajectoryPoints() - 2; i >=0; i--) {
-      partial_ranges[i] = partial_ranges[i+1] + (particle.Position(i+1).Vect() - particle.Position(i).Vect()).Mag();
-    }
+    // search tree over the trajectory points, and partial ranges
+    const caf::TruthIndex::Trajectory &trajectory = *truth_index.ParticleTrajectory(srtrack.truth.p.G4ID);
+    const std::vector<double> &partial_ranges = trajectory.PartialRanges();
 
     // Loop through the reco calo points
     for (unsigned iplane = 0; iplane < 3; iplane++) {
@@ -186,14 +171,8 @@ namespace caf {
         // Don't use this:
         // std::vector<sim::TrackIDE> ides = bt_serv->HitToTrackIDEs(clockData, hit);
         //
-        // Use this:
-        std::vector<sim::TrackIDE> h_ides = bt_serv->ChannelToTrackIDEs(clockData, p.channel, p.start, p.end);
-        truep.h_nelec = 0.;
-        truep.h_e = 0.;
-        for (const sim::TrackIDE &ide: h_ides) {
-          truep.h_e += ide.energy;
-          truep.h_nelec += ide.numElectrons;
-        }
+        // Use this (the sums over BackTrackerService::ChannelToTrackIDEs):
+        truth_index.ChannelEnergy(clockData, p.channel, p.start, p.end, truep.h_e, truep.h_nelec);
 
         // Particle based truth matching
 
@@ -236,14 +215,10 @@ namespace caf {
         // Match to MC-trajectory
         TVector3 direction;
         float closest_dist = -1.;
-        int traj_index = -1;
-        for (unsigned i_traj = 0; i_traj < particle.NumberTrajectoryPoints(); i_traj++) {
-          double this_dist = (particle.Position(i_traj).Vect() - loc_nosce_v).Mag2(); 
-          if (closest_dist < 0. || this_dist < closest_dist) {
-            direction = particle.Momentum(i_traj).Vect().Unit();
-            closest_dist = this_dist;
-            traj_index = i_traj;
-          }
+        int traj_index = trajectory.Nearest(loc_nosce_v.X(), loc_nosce_v.Y(), loc_nosce_v.Z());
+        if (traj_index >= 0) {
+          direction = particle.Momentum(traj_index).Vect().Unit();
+          closest_dist = (particle.Position(traj_index).Vect() - loc_nosce_v).Mag2();
         }
 
         // residual range
@@ -323,25 +298,25 @@ namespace caf {
   // N.B. this will only work if showers are rolled up
   void FillShowerTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                        const std::map<int, caf::HitsEnergy> &id_hits_map,
-                       const std::vector<caf::SRTrueParticle> &particles,
+                       const caf::TruthIndex &truth_index,
                        const detinfo::DetectorClocksData &clockData,
                        caf::SRShower& srshower,
                        bool allowEmpty)
   {
     // Truth matching
-    srshower.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srshower.truth = MatchTrack2Truth(clockData, truth_index, hits, id_hits_map);
 
   }//FillShowerTruth
 
 
   void FillStubTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                      const std::map<int, caf::HitsEnergy> &id_hits_map,
-                     const std::vector<caf::SRTrueParticle> &particles,
+                     const caf::TruthIndex &truth_index,
                      const detinfo::DetectorClocksData &clockData,
                      caf::SRStub& srstub,
                      bool allowEmpty) 
   {
-    srstub.truth = MatchTrack2Truth(clockData, particles, hits, id_hits_map);
+    srstub.truth = MatchTrack2Truth(clockData, truth_index, hits, id_hits_map);
   }
 
 
@@ -449,7 +424,7 @@ namespace caf {
   void FillTrueNeutrino(const art::Ptr<simb::MCTruth> mctruth,
       const simb::MCFlux &mcflux,
       const simb::GTruth& gtruth,
-      const std::vector<caf::SRTrueParticle> &srparticles,
+      const caf::TruthIndex &truth_index,
       const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
       caf::SRTrueInteraction &srneutrino, size_t i,
       const std::vector<geo::BoxBoundedGeo> &active_volumes) {
@@ -467,16 +442,18 @@ namespace caf {
       }
     }
 
-    for(const caf::SRTrueParticle& part: srparticles){
-      // save the G4 particles that came from this interaction
-      if(part.interaction_id == (int)i) {
-        if(part.start_process == caf::kG4primary) srneutrino.prim.push_back(part);
+    const std::vector<caf::SRTrueParticle> &srparticles = truth_index.SRParticles();
+    const std::vector<unsigned> &interaction_particles = truth_index.InteractionParticles(i);
 
-        // total up the deposited energy
-        for(int p = 0; p < 3; ++p) { 
-          for (int i_cryo = 0; i_cryo < 2; i_cryo++) {
-            srneutrino.plane[i_cryo][p].visE += part.plane[i_cryo][p].visE;
-          }
+    // save the G4 particles that came from this interaction
+    for (unsigned i_part: interaction_particles) {
+      const caf::SRTrueParticle& part = srparticles[i_part];
+      if(part.start_process == caf::kG4primary) srneutrino.prim.push_back(part);
+
+      // total up the deposited energy
+      for(int p = 0; p < 3; ++p) { 
+        for (int i_cryo = 0; i_cryo < 2; i_cryo++) {
+          srneutrino.plane[i_cryo][p].visE += part.plane[i_cryo][p].visE;
         }
       }
     }
@@ -485,8 +462,8 @@ namespace caf {
     // Set of hits per-plane: primary particles
     {
       std::vector<std::array<std::set<unsigned>, 3>> planehitIDs(2);
-      for (unsigned i_part = 0; i_part < srparticles.size(); i_part++) {
-        if (srparticles[i_part].start_process == caf::kG4primary && srparticles[i_part].interaction_id == (int)i) {
+      for (unsigned i_part: interaction_particles) {
+        if (srparticles[i_part].start_process == caf::kG4primary) {
           int track_id = srparticles[i_part].G4ID;
           // Look for hits
           if (!id_to_truehit_map.count(track_id)) continue;
@@ -507,15 +484,13 @@ namespace caf {
     // Set of hits per-plane: all particles
     {
       std::vector<std::array<std::set<unsigned>, 3>> planehitIDs(2);
-      for (unsigned i_part = 0; i_part < srparticles.size(); i_part++) {
-        if (srparticles[i_part].interaction_id == (int)i) {
-          int track_id = srparticles[i_part].G4ID;
-          // Look for hits
-          if (!id_to_truehit_map.count(track_id)) continue;
-          for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.at(track_id)) {
-            if (!h->WireID()) continue;
-            planehitIDs[h->WireID().Cryostat][h->WireID().Plane].insert(h.key());
-          }
+      for (unsigned i_part: interaction_particles) {
+        int track_id = srparticles[i_part].G4ID;
+        // Look for hits
+        if (!id_to_truehit_map.count(track_id)) continue;
+        for (const art::Ptr<recob::Hit> &h: id_to_truehit_map.at(track_id)) {
+          if (!h->WireID()) continue;
+          planehitIDs[h->WireID().Cryostat][h->WireID().Plane].insert(h.key());
         }
       }
 
@@ -1467,7 +1442,7 @@ float ContainedLength(const TVector3 &v0, const TVector3 &v1,
 }//ContainedLength
 
 //------------------------------------------------
-caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const std::vector<caf::SRTrueParticle> &particles, const std::vector<art::Ptr<recob::Hit>> &hits,
+caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData, const caf::TruthIndex &truth_index, const std::vector<art::Ptr<recob::Hit>> &hits,
 				   const std::map<int, caf::HitsEnergy> &all_hits_map) {
 
   art::ServiceHandle<cheat::BackTrackerService> bt_serv;
@@ -1508,12 +1483,9 @@ caf::SRTrackTruth MatchTrack2Truth(const detinfo::DetectorClocksData &clockData,
   bool found_bestmatch = false;
   if (ret.matches.size()) {
     ret.bestmatch = ret.matches.at(0);
-    for (unsigned i_part = 0; i_part < particles.size(); i_part++) {
-      if (particles[i_part].G4ID == ret.bestmatch.G4ID) {
-        ret.p = particles[i_part];
-        found_bestmatch = true;
-        break;
-      }
+    if (const caf::SRTrueParticle *match = truth_index.SRParticle(ret.bestmatch.G4ID)) {
+      ret.p = *match;
+      found_bestmatch = true;
     }
   }
 
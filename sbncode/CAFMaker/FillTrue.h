@@ -36,6 +36,8 @@
 #include "sbnanaobj/StandardRecord/StandardRecord.h"
 #include "sbnanaobj/StandardRecord/SRMeVPrtl.h"
 
+#include "TruthIndex.h"
+
 namespace caf
 {
   struct HitsEnergy {
@@ -89,7 +91,7 @@ namespace caf
   void FillTrueNeutrino(const art::Ptr<simb::MCTruth> mctruth, 
 			const simb::MCFlux &mcflux, 
                         const simb::GTruth& gtruth,
-			const std::vector<caf::SRTrueParticle> &srparticles,
+			const caf::TruthIndex &truth_index,
                         const std::map<int, std::vector<art::Ptr<recob::Hit>>> &id_to_truehit_map,
 			caf::SRTrueInteraction &srneutrino, size_t i,
                         const std::vector<geo::BoxBoundedGeo> &active_volumes);
@@ -100,13 +102,12 @@ namespace caf
 
   void FillTrackTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                       const std::map<int, caf::HitsEnergy> &id_hits_map,
-                      const std::vector<caf::SRTrueParticle> &particles,
+                      const caf::TruthIndex &truth_index,
                       const detinfo::DetectorClocksData &clockData,
                       caf::SRTrack& srtrack,
                       bool allowEmpty = false);
 
-  void FillTrackCaloTruth(const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> &id_to_ide_map,
-                          const std::vector<simb::MCParticle> &mc_particles,
+  void FillTrackCaloTruth(caf::TruthIndex &truth_index,
                           const geo::GeometryCore *geo,
                           const detinfo::DetectorClocksData &clockData,
                           const spacecharge::SpaceCharge *sce,
@@ -115,14 +116,14 @@ namespace caf
 
   void FillStubTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                      const std::map<int, caf::HitsEnergy> &id_hits_map,
-                     const std::vector<caf::SRTrueParticle> &particles,
+                     const caf::TruthIndex &truth_index,
                      const detinfo::DetectorClocksData &clockData,
                      caf::SRStub& srstub,
                      bool allowEmpty = false);
 
   void FillShowerTruth(const std::vector<art::Ptr<recob::Hit>> &hits,
                        const std::map<int, caf::HitsEnergy> &id_hits_map,
-                       const std::vector<caf::SRTrueParticle> &particles,
+                       const caf::TruthIndex &truth_index,
                        const detinfo::DetectorClocksData &clockData,
                        caf::SRShower& srshower,
                        bool allowEmpty = false);
@@ -0,0 +1,115 @@
+#ifndef CAF_RECORDWRITER_H
+#define CAF_RECORDWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace caf
+{
+  /// Hands completed records to a dedicated thread that writes them out.
+  ///
+  /// Records are written one at a time, in the order they were submitted.
+  /// At most \a capacity records wait in the queue; Submit blocks beyond that,
+  /// so the producer is at most that many records ahead of the output.
+  template<class T>
+  class RecordWriter
+  {
+  public:
+    RecordWriter(std::function<void(T&)> write, unsigned capacity)
+      : fWrite(write), fCapacity(capacity ? capacity : 1)
+    {
+      fThread = std::thread([this]() { Run(); });
+    }
+
+    ~RecordWriter()
+    {
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fStop = true;
+      }
+      fWork.notify_all();
+      fThread.join();
+    }
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    /// Queue a record, waiting for room if the queue is full. Rethrows an
+    /// exception raised while writing an earlier record.
+    void Submit(std::unique_ptr<T> rec)
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fRoom.wait(lock, [this]() { return fQueue.size() < fCapacity || fError; });
+      Rethrow();
+      fQueue.push_back(std::move(rec));
+      fWork.notify_one();
+    }
+
+    /// Wait until every submitted record has been written. The output may
+    /// be touched from the calling thread until the next Submit.
+    void Flush()
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fRoom.wait(lock, [this]() { return (fQueue.empty() && !fBusy) || fError; });
+      Rethrow();
+    }
+
+  private:
+    void Rethrow()
+    {
+      if (fError) {
+        std::exception_ptr error = fError;
+        fError = nullptr;
+        std::rethrow_exception(error);
+      }
+    }
+
+    void Run()
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (true) {
+        fWork.wait(lock, [this]() { return !fQueue.empty() || fStop; });
+        if (fQueue.empty()) return;
+
+        std::unique_ptr<T> rec = std::move(fQueue.front());
+        fQueue.pop_front();
+        fBusy = true;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+          fWrite(*rec);
+        }
+        catch (...) {
+          error = std::current_exception();
+        }
+        rec.reset();
+
+        lock.lock();
+        fBusy = false;
+        if (error && !fError) fError = error;
+        fRoom.notify_all();
+      }
+    }
+
+    std::function<void(T&)> fWrite;
+    unsigned fCapacity;
+
+    std::mutex fMutex;
+    std::condition_variable fWork;
+    std::condition_variable fRoom;
+    std::deque<std::unique_ptr<T>> fQueue;
+    bool fBusy = false;
+    bool fStop = false;
+    std::exception_ptr fError;
+
+    std::thread fThread;
+  };
+}
+
+#endif
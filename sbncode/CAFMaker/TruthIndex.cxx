@@ -0,0 +1,220 @@
+#include "TruthIndex.h"
+
+#include "TVector3.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace caf
+{
+  namespace {
+    // ranges at most this long are scanned instead of split
+    constexpr unsigned kTrajectoryLeafSize = 8;
+  }
+
+  //------------------------------------------------
+
+  TruthIndex::Trajectory::Trajectory(const simb::MCParticle &particle)
+  {
+    unsigned npoints = particle.NumberTrajectoryPoints();
+    fX.reserve(npoints);
+    fY.reserve(npoints);
+    fZ.reserve(npoints);
+    for (unsigned i = 0; i < npoints; i++) {
+      fX.push_back(particle.Vx(i));
+      fY.push_back(particle.Vy(i));
+      fZ.push_back(particle.Vz(i));
+    }
+
+    // pre-compute partial ranges
+    fPartialRanges.assign(npoints, 0);
+    for (int i = npoints - 2; i >=0; i--) {
+      fPartialRanges[i] = fPartialRanges[i+1] + (particle.Position(i+1).Vect() - particle.Position(i).Vect()).Mag();
+    }
+
+    fNodes.resize(npoints);
+    for (unsigned i = 0; i < npoints; i++) fNodes[i] = {i, -1};
+    if (npoints) Build(0, npoints);
+  }
+
+  void TruthIndex::Trajectory::Build(unsigned begin, unsigned end)
+  {
+    if (end - begin <= kTrajectoryLeafSize) return;
+
+    // split along the axis with the largest extent
+    double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    double hi[3] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    for (unsigned i = begin; i < end; i++) {
+      unsigned p = fNodes[i].point;
+      lo[0] = std::min(lo[0], fX[p]); hi[0] = std::max(hi[0], fX[p]);
+      lo[1] = std::min(lo[1], fY[p]); hi[1] = std::max(hi[1], fY[p]);
+      lo[2] = std::min(lo[2], fZ[p]); hi[2] = std::max(hi[2], fZ[p]);
+    }
+    int axis = 0;
+    if (hi[1] - lo[1] > hi[axis] - lo[axis]) axis = 1;
+    if (hi[2] - lo[2] > hi[axis] - lo[axis]) axis = 2;
+    const std::vector<double> &coord = (axis == 0) ? fX : ((axis == 1) ? fY : fZ);
+
+    unsigned mid = begin + (end - begin) / 2;
+    std::nth_element(fNodes.begin() + begin, fNodes.begin() + mid, fNodes.begin() + end,
+                     [&coord](const Node &a, const Node &b) { return coord[a.point] < coord[b.point]; });
+    fNodes[mid].axis = axis;
+
+    Build(begin, mid);
+    Build(mid + 1, end);
+  }
+
+  double TruthIndex::Trajectory::Dist2(unsigned i, const double q[3]) const
+  {
+    // same arithmetic as (Position(i).Vect() - q).Mag2()
+    double dx = fX[i] - q[0];
+    double dy = fY[i] - q[1];
+    double dz = fZ[i] - q[2];
+    return dx*dx + dy*dy + dz*dz;
+  }
+
+  void TruthIndex::Trajectory::Search(unsigned begin, unsigned end, const double q[3], int &best, double &best_dist) const
+  {
+    auto test = [&](unsigned p) {
+      double d = Dist2(p, q);
+      if (best < 0 || d < best_dist || (d == best_dist && (int)p < best)) {
+        best = p;
+        best_dist = d;
+      }
+    };
+
+    if (end - begin <= kTrajectoryLeafSize) {
+      for (unsigned i = begin; i < end; i++) test(fNodes[i].point);
+      return;
+    }
+
+    unsigned mid = begin + (end - begin) / 2;
+    const Node &node = fNodes[mid];
+    test(node.point);
+
+    const std::vector<double> &coord = (node.axis == 0) ? fX : ((node.axis == 1) ? fY : fZ);
+    double diff = q[node.axis] - coord[node.point];
+
+    if (diff < 0) {
+      Search(begin, mid, q, best, best_dist);
+      // points on the far side are at least |diff| away; visit on equality to resolve ties
+      if (diff*diff <= best_dist) Search(mid + 1, end, q, best, best_dist);
+    }
+    else {
+      Search(mid + 1, end, q, best, best_dist);
+      if (diff*diff <= best_dist) Search(begin, mid, q, best, best_dist);
+    }
+  }
+
+  int TruthIndex::Trajectory::Nearest(double x, double y, double z) const
+  {
+    double q[3] = {x, y, z};
+    int best = -1;
+    double best_dist = std::numeric_limits<double>::max();
+    if (!fNodes.empty()) Search(0, fNodes.size(), q, best, best_dist);
+    return best;
+  }
+
+  //------------------------------------------------
+
+  TruthIndex::TruthIndex(const std::vector<simb::MCParticle> *mc_particles,
+                         const std::vector<caf::SRTrueParticle> *srparticles,
+                         const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> *id_to_ide_map,
+                         const std::vector<art::Ptr<sim::SimChannel>> &simchannels,
+                         const geo::GeometryCore *geo)
+    : fSRParticles(srparticles)
+    , fIDEMap(id_to_ide_map)
+    , fGeo(geo)
+  {
+    if (mc_particles) {
+      fParticles.reserve(mc_particles->size());
+      // keep the first particle of a track ID, like a forward scan would
+      for (const simb::MCParticle &p: *mc_particles) fParticles.emplace(p.TrackId(), &p);
+    }
+
+    if (srparticles) {
+      fSRParticleIndex.reserve(srparticles->size());
+      for (unsigned i_part = 0; i_part < srparticles->size(); i_part++) {
+        const caf::SRTrueParticle &part = (*srparticles)[i_part];
+        fSRParticleIndex.emplace(part.G4ID, i_part);
+        fInteractionParticles[part.interaction_id].push_back(i_part);
+      }
+    }
+
+    fSimChannels.reserve(simchannels.size());
+    for (const art::Ptr<sim::SimChannel> &sc: simchannels) fSimChannels.emplace(sc->Channel(), sc.get());
+  }
+
+  const simb::MCParticle *TruthIndex::Particle(int G4ID) const
+  {
+    auto it = fParticles.find(G4ID);
+    return (it != fParticles.end()) ? it->second : nullptr;
+  }
+
+  const caf::SRTrueParticle *TruthIndex::SRParticle(int G4ID) const
+  {
+    auto it = fSRParticleIndex.find(G4ID);
+    return (it != fSRParticleIndex.end()) ? &(*fSRParticles)[it->second] : nullptr;
+  }
+
+  const std::vector<caf::SRTrueParticle> &TruthIndex::SRParticles() const
+  {
+    static const std::vector<caf::SRTrueParticle> empty;
+    return fSRParticles ? *fSRParticles : empty;
+  }
+
+  const std::vector<unsigned> &TruthIndex::InteractionParticles(int interaction_id) const
+  {
+    static const std::vector<unsigned> empty;
+    auto it = fInteractionParticles.find(interaction_id);
+    return (it != fInteractionParticles.end()) ? it->second : empty;
+  }
+
+  const TruthIndex::Trajectory *TruthIndex::ParticleTrajectory(int G4ID)
+  {
+    auto it = fTrajectories.find(G4ID);
+    if (it != fTrajectories.end()) return it->second.get();
+
+    const simb::MCParticle *particle = Particle(G4ID);
+    if (!particle) return nullptr;
+    return fTrajectories.emplace(G4ID, std::make_unique<Trajectory>(*particle)).first->second.get();
+  }
+
+  const std::map<unsigned, std::vector<const sim::IDE*>> *TruthIndex::ChannelIDEs(int G4ID)
+  {
+    auto it = fChannelIDEs.find(G4ID);
+    if (it != fChannelIDEs.end()) return &it->second;
+
+    if (!fIDEMap || !fIDEMap->count(G4ID)) return nullptr;
+
+    // match on the channel, which is unique
+    std::map<unsigned, std::vector<const sim::IDE *>> &chan_2_ides = fChannelIDEs[G4ID];
+    for (auto const &ide_pair: fIDEMap->at(G4ID)) {
+      chan_2_ides[fGeo->PlaneWireToChannel(ide_pair.first)].push_back(ide_pair.second);
+    }
+    return &chan_2_ides;
+  }
+
+  void TruthIndex::ChannelEnergy(const detinfo::DetectorClocksData &clockData, unsigned channel,
+                                 double start, double end, float &energy, float &nelec) const
+  {
+    energy = 0.;
+    nelec = 0.;
+
+    auto it = fSimChannels.find(channel);
+    if (it == fSimChannels.end()) return;
+
+    // same TDC range as BackTracker::ChannelToTrackIDEs
+    int start_tdc = clockData.TPCTick2TDC(start);
+    int end_tdc = clockData.TPCTick2TDC(end);
+    if (start_tdc < 0 && end_tdc < 0) return;
+    if (start_tdc < 0) start_tdc = 0;
+    if (end_tdc < 0) end_tdc = 0;
+
+    for (const sim::IDE &ide: it->second->TrackIDsAndEnergies(start_tdc, end_tdc)) {
+      if (ide.trackID == sim::NoParticleId) continue;
+      energy += ide.energy;
+      nelec += ide.numElectrons;
+    }
+  }
+}
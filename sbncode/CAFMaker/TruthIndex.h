@@ -0,0 +1,103 @@
+#ifndef CAF_TRUTHINDEX_H
+#define CAF_TRUTHINDEX_H
+
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
+#include "lardataobj/Simulation/SimChannel.h"
+#include "nusimdata/SimulationBase/MCParticle.h"
+#include "canvas/Persistency/Common/Ptr.h"
+
+#include "sbnanaobj/StandardRecord/SRTrueParticle.h"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace caf
+{
+  /// Per-event lookup tables shared by the truth filling routines.
+  ///
+  /// Built once per event from the products the CAFMaker already holds, so
+  /// that matching a reco object to the truth does not scan every particle.
+  /// Per-particle tables (trajectory search tree, residual ranges, IDEs by
+  /// channel) are built the first time the particle is looked up.
+  class TruthIndex
+  {
+  public:
+    /// Trajectory search structure of one MCParticle
+    class Trajectory
+    {
+    public:
+      explicit Trajectory(const simb::MCParticle &particle);
+
+      /// Index of the trajectory point closest to (x, y, z), the first one
+      /// on ties, or -1 if the trajectory is empty
+      int Nearest(double x, double y, double z) const;
+
+      /// Path length from each trajectory point to the end of the trajectory
+      const std::vector<double> &PartialRanges() const { return fPartialRanges; }
+
+    private:
+      struct Node {
+        unsigned point;
+        int axis; ///< split axis, -1 for a leaf
+      };
+
+      void Build(unsigned begin, unsigned end);
+      void Search(unsigned begin, unsigned end, const double q[3], int &best, double &best_dist) const;
+      double Dist2(unsigned i, const double q[3]) const;
+
+      std::vector<double> fX, fY, fZ;
+      std::vector<double> fPartialRanges;
+      // implicit balanced k-d tree: the node of [begin, end) is stored at the median
+      std::vector<Node> fNodes;
+    };
+
+    TruthIndex() = default;
+
+    /// simchannels must be the ones the BackTrackerService serves
+    TruthIndex(const std::vector<simb::MCParticle> *mc_particles,
+               const std::vector<caf::SRTrueParticle> *srparticles,
+               const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> *id_to_ide_map,
+               const std::vector<art::Ptr<sim::SimChannel>> &simchannels,
+               const geo::GeometryCore *geo);
+
+    /// MCParticle with this G4 track ID, or nullptr
+    const simb::MCParticle *Particle(int G4ID) const;
+    /// SRTrueParticle with this G4 track ID, or nullptr
+    const caf::SRTrueParticle *SRParticle(int G4ID) const;
+    /// All the SRTrueParticles, in the order they were filled
+    const std::vector<caf::SRTrueParticle> &SRParticles() const;
+    /// Indices of the SRTrueParticles of an interaction, in increasing order
+    const std::vector<unsigned> &InteractionParticles(int interaction_id) const;
+
+    /// Trajectory search structure of the particle with this G4 track ID, or nullptr
+    const Trajectory *ParticleTrajectory(int G4ID);
+    /// IDEs of the particle with this G4 track ID, by channel, or nullptr
+    const std::map<unsigned, std::vector<const sim::IDE*>> *ChannelIDEs(int G4ID);
+
+    /// Energy and number of electrons of the particle-tagged simchannel IDEs on
+    /// a channel between two TPC ticks. These are the sums over the output of
+    /// BackTrackerService::ChannelToTrackIDEs for the same arguments.
+    void ChannelEnergy(const detinfo::DetectorClocksData &clockData, unsigned channel,
+                       double start, double end, float &energy, float &nelec) const;
+
+  private:
+    const std::vector<caf::SRTrueParticle> *fSRParticles = nullptr;
+    const std::map<int, std::vector<std::pair<geo::WireID, const sim::IDE*>>> *fIDEMap = nullptr;
+    const geo::GeometryCore *fGeo = nullptr;
+
+    std::unordered_map<int, const simb::MCParticle*> fParticles;
+    std::unordered_map<int, unsigned> fSRParticleIndex;
+    std::unordered_map<int, std::vector<unsigned>> fInteractionParticles;
+    std::unordered_map<unsigned, const sim::SimChannel*> fSimChannels;
+
+    // built on first use
+    std::unordered_map<int, std::unique_ptr<Trajectory>> fTrajectories;
+    std::unordered_map<int, std::map<unsigned, std::vector<const sim::IDE*>>> fChannelIDEs;
+  };
+}
+
+#endif
@@ -41,9 +41,11 @@
 #include "sbnobj/Common/Reco/StoppingChi2Fit.h"
 #include "sbncode/LArRecoProducer/TrackStoppingChi2Alg.h"
 #include "sbnobj/Common/Reco/CRUMBSResult.h"
+#include "sbncode/PID/BDTEvaluator.h"
 
 #include "TTree.h"
-#include "TMVA/Reader.h"
+
+#include <memory>
 
 class CRUMBS;
 
@@ -63,7 +65,7 @@ namespace sbn {
     // Required functions.
     void produce(art::Event& e) override;
 
-    void InitialiseMVAReader(TMVA::Reader &mvaReader, std::string &mvaName, std::string &mvaFileName);
+    std::unique_ptr<sbn::BDTEvaluator> InitialiseMVA(const std::string &mvaName, const std::string &mvaFileName);
 
     void ResetVars();
 
@@ -117,8 +119,8 @@ namespace sbn {
     // Tree for storing training information
     TTree *fSliceTree;
     
-    // TMVA reader for calculating CRUMBS score
-    TMVA::Reader fMVAReader, fCCNuMuMVAReader, fCCNuEMVAReader, fNCMVAReader;
+    // BDTs for calculating CRUMBS score
+    std::unique_ptr<sbn::BDTEvaluator> fMVA, fCCNuMuMVA, fCCNuEMVA, fNCMVA;
 
     // Other useful information for training tree
     float tpc_NuScore;
@@ -198,10 +200,10 @@ namespace sbn {
 	  produces<std::vector<CRUMBSResult>>();
 	  produces<art::Assns<recob::Slice, CRUMBSResult>>();
 
-	  InitialiseMVAReader(fMVAReader, fMVAName, fMVAFileName);
-	  InitialiseMVAReader(fCCNuMuMVAReader, fCCNuMuMVAName, fCCNuMuMVAFileName);
-	  InitialiseMVAReader(fCCNuEMVAReader, fCCNuEMVAName, fCCNuEMVAFileName);
-	  InitialiseMVAReader(fNCMVAReader, fNCMVAName, fNCMVAFileName);
+	  fMVA       = InitialiseMVA(fMVAName, fMVAFileName);
+	  fCCNuMuMVA = InitialiseMVA(fCCNuMuMVAName, fCCNuMuMVAFileName);
+	  fCCNuEMVA  = InitialiseMVA(fCCNuEMVAName, fCCNuEMVAFileName);
+	  fNCMVA     = InitialiseMVA(fNCMVAName, fNCMVAFileName);
 	}
 
       art::ServiceHandle<art::TFileService> tfs;
@@ -243,35 +245,33 @@ namespace sbn {
         }
     }
 
-  void CRUMBS::InitialiseMVAReader(TMVA::Reader &mvaReader, std::string &mvaName, std::string &mvaFileName)
+  std::unique_ptr<sbn::BDTEvaluator> CRUMBS::InitialiseMVA(const std::string &mvaName, const std::string &mvaFileName)
   {
-    mvaReader.AddVariable("tpc_CRFracHitsInLongestTrack",&tpc_CRFracHitsInLongestTrack);
-    mvaReader.AddVariable("tpc_CRLongestTrackDeflection",&tpc_CRLongestTrackDeflection);
-    mvaReader.AddVariable("tpc_CRLongestTrackDirY",&tpc_CRLongestTrackDirY);
-    mvaReader.AddVariable("tpc_CRNHitsMax",&tpc_CRNHitsMax);
-    mvaReader.AddVariable("tpc_NuEigenRatioInSphere",&tpc_NuEigenRatioInSphere);
-    mvaReader.AddVariable("tpc_NuNFinalStatePfos",&tpc_NuNFinalStatePfos);
-    mvaReader.AddVariable("tpc_NuNHitsTotal",&tpc_NuNHitsTotal);
-    mvaReader.AddVariable("tpc_NuNSpacePointsInSphere",&tpc_NuNSpacePointsInSphere);
-    mvaReader.AddVariable("tpc_NuVertexY",&tpc_NuVertexY);
-    mvaReader.AddVariable("tpc_NuWeightedDirZ",&tpc_NuWeightedDirZ);
-    mvaReader.AddVariable("tpc_StoppingChi2CosmicRatio",&tpc_StoppingChi2CosmicRatio);
-
-    mvaReader.AddVariable("pds_FMTotalScore",&pds_FMTotalScore);
-    mvaReader.AddVariable("pds_FMPE",&pds_FMPE);
-    mvaReader.AddVariable("pds_FMTime",&pds_FMTime);
-
-    mvaReader.AddVariable("crt_TrackScore",&crt_TrackScore);
-    mvaReader.AddVariable("crt_HitScore",&crt_HitScore);
-    mvaReader.AddVariable("crt_TrackTime",&crt_TrackTime);
-    mvaReader.AddVariable("crt_HitTime",&crt_HitTime);
-
     cet::search_path searchPath("FW_SEARCH_PATH");
     std::string weightFileFullPath;
     if (!searchPath.find_file(mvaFileName, weightFileFullPath))
-      throw cet::exception("CRUMBS") << "Unable to find weight file: " << mvaFileName << " in FW_SEARCH_PATH: " << searchPath.to_string();
-
-    mvaReader.BookMVA(mvaName, weightFileFullPath);
+      throw cet::exception("CRUMBS") << "Unable to find weight file for " << mvaName << ": " << mvaFileName << " in FW_SEARCH_PATH: " << searchPath.to_string();
+
+    // The order has to match the training, the features added in produce and the CRUMBSResult inputs
+    return std::make_unique<sbn::BDTEvaluator>(weightFileFullPath,
+                                               std::vector<std::string>{"tpc_CRFracHitsInLongestTrack",
+                                                                        "tpc_CRLongestTrackDeflection",
+                                                                        "tpc_CRLongestTrackDirY",
+                                                                        "tpc_CRNHitsMax",
+                                                                        "tpc_NuEigenRatioInSphere",
+                                                                        "tpc_NuNFinalStatePfos",
+                                                                        "tpc_NuNHitsTotal",
+                                                                        "tpc_NuNSpacePointsInSphere",
+                                                                        "tpc_NuVertexY",
+                                                                        "tpc_NuWeightedDirZ",
+                                                                        "tpc_StoppingChi2CosmicRatio",
+                                                                        "pds_FMTotalScore",
+                                                                        "pds_FMPE",
+                                                                        "pds_FMTime",
+                                                                        "crt_TrackScore",
+                                                                        "crt_HitScore",
+                                                                        "crt_TrackTime",
+                                                                        "crt_HitTime"});
   }
 
   void CRUMBS::ResetVars()
@@ -382,6 +382,10 @@ namespace sbn {
     art::FindManyP<larpandoraobj::PFParticleMetadata> pfpMetadataAssoc(handlePFPs, e, fPFParticleModuleLabel);
     art::FindManyP<sbn::SimpleFlashMatch> pfpFMAssoc(handlePFPs, e, fFlashMatchModuleLabel);
 
+    // Slices are scored together once all of them are filled
+    sbn::BDTFeatures mvaFeatures;
+    std::vector<art::Ptr<recob::Slice>> mvaSlices;
+
     for(auto const &slice : slices)
       {
         this->ResetVars();
@@ -415,21 +419,11 @@ namespace sbn {
       
 	if(!fTrainingMode || fEvaluateResultInTrainingMode)
 	  {
-	    const float score       = fMVAReader.EvaluateMVA(fMVAName);
-	    const float ccnumuscore = fCCNuMuMVAReader.EvaluateMVA(fCCNuMuMVAName);
-	    const float ccnuescore  = fCCNuEMVAReader.EvaluateMVA(fCCNuEMVAName);
-	    const float ncscore     = fNCMVAReader.EvaluateMVA(fNCMVAName);
-
-	    const float bestscore   = (ccnumuscore > ccnuescore && ccnumuscore > ncscore) ? ccnumuscore : (ccnuescore > ncscore) ? ccnuescore : ncscore;
-	    const int   bestid      = (ccnumuscore > ccnuescore && ccnumuscore > ncscore) ? 14 : (ccnuescore > ncscore) ? 12 : 1;
-	    
-	    resultsVec->emplace_back(score, ccnumuscore, ccnuescore, ncscore, bestscore, bestid, tpc_CRFracHitsInLongestTrack, tpc_CRLongestTrackDeflection, 
-				     tpc_CRLongestTrackDirY, std::round(tpc_CRNHitsMax), tpc_NuEigenRatioInSphere, std::round(tpc_NuNFinalStatePfos), 
-				     std::round(tpc_NuNHitsTotal), std::round(tpc_NuNSpacePointsInSphere), tpc_NuVertexY, tpc_NuWeightedDirZ, 
-				     tpc_StoppingChi2CosmicRatio, pds_FMTotalScore, pds_FMPE, pds_FMTime, crt_TrackScore, crt_HitScore, 
-				     crt_TrackTime, crt_HitTime);
-	    
-	    util::CreateAssn(*this, e, *resultsVec, slice, *sliceAssns);
+	    mvaFeatures.Add({tpc_CRFracHitsInLongestTrack, tpc_CRLongestTrackDeflection, tpc_CRLongestTrackDirY, tpc_CRNHitsMax,
+			     tpc_NuEigenRatioInSphere, tpc_NuNFinalStatePfos, tpc_NuNHitsTotal, tpc_NuNSpacePointsInSphere, tpc_NuVertexY,
+			     tpc_NuWeightedDirZ, tpc_StoppingChi2CosmicRatio, pds_FMTotalScore, pds_FMPE, pds_FMTime, crt_TrackScore,
+			     crt_HitScore, crt_TrackTime, crt_HitTime});
+	    mvaSlices.push_back(slice);
 	  }
 
         if(fTrainingMode)
@@ -451,6 +445,33 @@ namespace sbn {
 
     if(!fTrainingMode || fEvaluateResultInTrainingMode)
       {
+	const std::vector<float> scores       = fMVA->EvaluateMVA(mvaFeatures);
+	const std::vector<float> ccnumuscores = fCCNuMuMVA->EvaluateMVA(mvaFeatures);
+	const std::vector<float> ccnuescores  = fCCNuEMVA->EvaluateMVA(mvaFeatures);
+	const std::vector<float> ncscores     = fNCMVA->EvaluateMVA(mvaFeatures);
+
+	for(unsigned i = 0; i < mvaSlices.size(); ++i)
+	  {
+	    const float score       = scores[i];
+	    const float ccnumuscore = ccnumuscores[i];
+	    const float ccnuescore  = ccnuescores[i];
+	    const float ncscore     = ncscores[i];
+
+	    const float bestscore   = (ccnumuscore > ccnuescore && ccnumuscore > ncscore) ? ccnumuscore : (ccnuescore > ncscore) ? ccnuescore : ncscore;
+	    const int   bestid      = (ccnumuscore > ccnuescore && ccnumuscore > ncscore) ? 14 : (ccnuescore > ncscore) ? 12 : 1;
+
+	    // the inputs of this slice, in the order they were added
+	    auto const input = [&mvaFeatures, i](unsigned ivar) { return mvaFeatures.Column(ivar)[i]; };
+
+	    resultsVec->emplace_back(score, ccnumuscore, ccnuescore, ncscore, bestscore, bestid, input(0), input(1),
+				     input(2), std::round(input(3)), input(4), std::round(input(5)),
+				     std::round(input(6)), std::round(input(7)), input(8), input(9),
+				     input(10), input(11), input(12), input(13), input(14), input(15),
+				     input(16), input(17));
+
+	    util::CreateAssn(*this, e, *resultsVec, mvaSlices[i], *sliceAssns);
+	  }
+
 	e.put(std::move(resultsVec));
 	e.put(std::move(sliceAssns));
       }
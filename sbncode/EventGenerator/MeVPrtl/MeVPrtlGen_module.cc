@@ -17,6 +17,7 @@
 #include "art_root_io/TFileService.h"
 
 #include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 #include "lardata/Utilities/AssociationUtil.h"
@@ -47,6 +48,7 @@
 
 #include <memory>
 #include <chrono>
+#include <algorithm>
 
 namespace evgen {
   namespace ldm {
@@ -76,6 +78,9 @@ public:
 
   bool Deweight(double &weight, double &max_weight);
 
+  // Run a new block of candidates through all the stages
+  void ProcessBlock();
+
   ~MeVPrtlGen() noexcept {
     std::cout << "GenTool called (" << fNCalls[0] << ") times. Total duration (" << fNTime[0] << ") ms. Duration per call (" << (fNTime[0] / fNCalls[0]) << ") ms.\n";
     std::cout << "FlxTool called (" << fNCalls[1] << ") times. Total duration (" << fNTime[1] << ") ms. Duration per call (" << (fNTime[1] / fNCalls[1]) << ") ms.\n";
@@ -99,6 +104,31 @@ private:
   std::unique_ptr<evgen::ldm::IRayTrace> fRayTool;
   std::unique_ptr<evgen::ldm::IMeVPrtlDecay> fDecayTool;
 
+  size_t fCandidateBlockSize;
+
+  // Candidates of the current block in structure-of-arrays form.
+  // Each stage runs over the whole block, then the events consume the
+  // candidates in order starting from `next`.
+  struct CandidateBlock {
+    std::vector<simb::MCFlux> meson;
+    std::vector<double> pot;
+    std::vector<evgen::ldm::MeVPrtlFlux> flux;
+    std::vector<double> flux_weight;
+    std::vector<std::array<TVector3, 2>> intersection;
+    std::vector<double> ray_weight;
+    std::vector<evgen::ldm::MeVPrtlDecay> decay;
+    std::vector<double> decay_weight;
+    std::vector<double> ray_decay_weight;
+    std::vector<char> pass;
+    size_t next = 0;
+
+    size_t size() const { return meson.size(); }
+  };
+  CandidateBlock fBlock;
+
+  // POT of the candidates consumed since the last accepted one
+  double fPendingPOT;
+
   double fGenMaxWeight;
   double fFluxMaxWeight;
   double fRayMaxWeight;
@@ -127,6 +157,15 @@ evgen::ldm::MeVPrtlGen::MeVPrtlGen(fhicl::ParameterSet const& p)
 
   fDoDeweight = p.get<bool>("Deweight", false);
   fSubRunPOT = 0.;
+  fPendingPOT = 0.;
+
+  // Number of candidates run through each stage at a time. Each tool still
+  // sees its candidates in the same order and the POT is tallied per candidate,
+  // so only the order of the deweighting throws depends on it.
+  fCandidateBlockSize = p.get<size_t>("CandidateBlockSize", 1);
+  if (fCandidateBlockSize == 0) {
+    throw cet::exception("MeVPrtlGen") << "CandidateBlockSize must be at least 1.\n";
+  }
 
   // Update constants
   if (p.has_key("Constants")) Constants::Configure(p.get<fhicl::ParameterSet>("Constants"));
@@ -228,6 +267,54 @@ bool evgen::ldm::MeVPrtlGen::Deweight(double &weight, double &max_weight) {
   return rand <= test;
 }
 
+void evgen::ldm::MeVPrtlGen::ProcessBlock() {
+  CandidateBlock &b = fBlock;
+  size_t n = fCandidateBlockSize;
+
+  std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+  fGenTool->GetNextN(n, b.meson, b.pot);
+  fNCalls[0] += n;
+  std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> duration = t2 - t1;
+  fNTime[0] += duration.count();
+
+  b.pass.assign(n, 1);
+
+  fNCalls[1] += n;
+  t1 = std::chrono::high_resolution_clock::now();
+  fFluxTool->MakeFluxBatch(b.meson, b.flux, b.flux_weight, b.pass);
+  for (size_t i = 0; i < n; i++) {
+    if (b.pass[i]) b.pass[i] = Deweight(b.flux_weight[i], fFluxMaxWeight);
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  duration = t2 - t1;
+  fNTime[1] += duration.count();
+
+  fNCalls[2] += std::count(b.pass.begin(), b.pass.end(), 1);
+  t1 = std::chrono::high_resolution_clock::now();
+  fRayTool->IntersectDetectorBatch(b.flux, b.intersection, b.ray_weight, b.pass);
+  t2 = std::chrono::high_resolution_clock::now();
+  duration = t2 - t1;
+  fNTime[2] += duration.count();
+
+  fNCalls[3] += std::count(b.pass.begin(), b.pass.end(), 1);
+  t1 = std::chrono::high_resolution_clock::now();
+  fDecayTool->DecayBatch(b.flux, b.intersection, b.decay, b.decay_weight, b.pass);
+  t2 = std::chrono::high_resolution_clock::now();
+  duration = t2 - t1;
+  fNTime[3] += duration.count();
+
+  // Deweight the ray and decay weights together because they have some anti-correlation
+  b.ray_decay_weight.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    if (!b.pass[i]) continue;
+    b.ray_decay_weight[i] = b.ray_weight[i] * b.decay_weight[i];
+    b.pass[i] = Deweight(b.ray_decay_weight[i], fRayDecayMaxWeight);
+  }
+
+  b.next = 0;
+}
+
 void evgen::ldm::MeVPrtlGen::produce(art::Event& evt)
 {
   std::unique_ptr<std::vector<simb::MCFlux>> mcfluxColl(new std::vector<simb::MCFlux>);
@@ -242,12 +329,11 @@ void evgen::ldm::MeVPrtlGen::produce(art::Event& evt)
   // get the next MeVPrtl Truth
   while (1) {
 
-    std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
-    simb::MCFlux meson = fGenTool->GetNext();
-    fNCalls[0] ++;
-    std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double, std::milli> duration = t2 - t1;
-    fNTime[0] = duration.count();
+    if (fBlock.next >= fBlock.size()) ProcessBlock();
+    size_t i_c = fBlock.next++;
+
+    const simb::MCFlux &meson = fBlock.meson[i_c];
+    fPendingPOT += fBlock.pot[i_c];
 
     evgen::ldm::MesonParent mesonp(meson);
     bool is_meson = mesonp.meson_pdg != 0;
@@ -261,65 +347,29 @@ void evgen::ldm::MeVPrtlGen::produce(art::Event& evt)
       }
     }
 
-    bool success;
+    if (!fBlock.pass[i_c]) continue;
 
-    evgen::ldm::MeVPrtlFlux flux;
-    double flux_weight;
+    const evgen::ldm::MeVPrtlFlux &flux = fBlock.flux[i_c];
+    const std::array<TVector3, 2> &intersection = fBlock.intersection[i_c];
+    const evgen::ldm::MeVPrtlDecay &decay = fBlock.decay[i_c];
+    double flux_weight = fBlock.flux_weight[i_c];
+    double ray_weight = fBlock.ray_weight[i_c];
+    double decay_weight = fBlock.decay_weight[i_c];
+    double ray_decay_weight = fBlock.ray_decay_weight[i_c];
 
-    fNCalls[1] ++;
-    t1 = std::chrono::high_resolution_clock::now();
-    success = fFluxTool->MakeFlux(meson, flux, flux_weight) && Deweight(flux_weight, fFluxMaxWeight);
-    t2 = std::chrono::high_resolution_clock::now();
-    duration = t2 - t1;
-    fNTime[1] += duration.count();
-
-    if (!success) continue;
-    
     if (fVerbose){
       std::cout << "New flux. E=" << flux.mom.E() << " At: (" << flux.pos.X() << ", " << flux.pos.Y() << ", " << flux.pos.Z() << ")" << std::endl;
       std::cout << "P=(" << flux.mom.Px() << ", " << flux.mom.Py() << ", " << flux.mom.Pz() << ")" << std::endl;
       std::cout << "Flux weight: " << flux_weight << std::endl;
+      std::cout << "Ray weight: " << ray_weight << std::endl;
+      std::cout << "Decay weight: " << decay_weight << std::endl;
+      std::cout << "RayDecay weight: " << ray_decay_weight << std::endl;
+      std::cout << "PASSED!\n";
     }
 
-    std::array<TVector3, 2> intersection;
-    double ray_weight;
-
-    fNCalls[2] ++;
-    t1 = std::chrono::high_resolution_clock::now();
-    success = fRayTool->IntersectDetector(flux, intersection, ray_weight);
-    t2 = std::chrono::high_resolution_clock::now();
-    duration = t2 - t1;
-    fNTime[2] += duration.count();
-
-    if (!success) continue;
-    if (fVerbose) std::cout << "Ray weight: " << ray_weight << std::endl;
-
-    evgen::ldm::MeVPrtlDecay decay;
-    double decay_weight;
-
-    fNCalls[3] ++;
-    t1 = std::chrono::high_resolution_clock::now();
-    success = fDecayTool->Decay(flux, intersection[0], intersection[1], decay, decay_weight);
-    t2 = std::chrono::high_resolution_clock::now();
-    duration = t2 - t1;
-    fNTime[3] += duration.count();
-
-    if (!success) continue;
-
-    if (fVerbose) std::cout << "Decay weight: " << decay_weight << std::endl;
-
-    // Deweight the ray and decay weights together because they have some anti-correlation
-    double ray_decay_weight = ray_weight * decay_weight;
-    success = Deweight(ray_decay_weight, fRayDecayMaxWeight);
-
-    if (!success) continue;
-
-    if (fVerbose) std::cout << "RayDecay weight: " << ray_decay_weight << std::endl;
-    if (fVerbose) std::cout << "PASSED!\n";
-
-
     // get the POT
-    double thisPOT = fGenTool->GetPOT();
+    double thisPOT = fPendingPOT;
+    fPendingPOT = 0.;
 
     // if we are de-weighting, then the scaling all gets put into the POT variable
     if (fDoDeweight) {
@@ -20,6 +20,7 @@
 // local includes
 #include "IMesonGen.h"
 #include "boone.h"
+#include "FluxFileStream.h"
 #include "PDGCodes.h"
 
 // LArSoft includes
@@ -62,6 +63,7 @@ public:
 
     double GetPOT() override;
     simb::MCFlux GetNext() override;
+    void GetNextN(size_t n, std::vector<simb::MCFlux> &mesons, std::vector<double> &pot) override;
 
     void configure(const fhicl::ParameterSet&) override;
 
@@ -70,7 +72,10 @@ public:
     std::vector<std::string> LoadFluxFiles();
     simb::MCFlux MakeMCFlux(const bsim::Dk2Nu &dk2nu);
     simb::MCFlux MakeMCFlux(const bsim::BooNe &boone);
-    double LoadPOT();
+    double LoadPOT(TFile &file);
+
+    // decode the next block of entries
+    void ReadBlock();
 
     // no weights
     double MaxWeight() override { return -1.; }
@@ -86,25 +91,24 @@ private:
   
   std::string fTreeName;
   std::string fMetaTreeName;
+  bool fPrefetchFiles;
+  Long64_t fTreeCacheSize;
+  unsigned fReadBlockSize;
 
-  // info for tracking files
-  unsigned fFileIndex;
-  bool fNewFile;
   std::vector<std::string> fFluxFiles;
 
-  // info for tracking entry in file
-  unsigned fEntry;
-  unsigned fEntryStart;
-
   // ROOT Holders
-  TTree *fFluxTree;
-  TFile *fFluxFile;
+  std::unique_ptr<FluxFileStream> fFluxStream;
   bsim::Dk2Nu *fDk2Nu;
   bsim::BooNe *fBooNe;
 
+  // decoded entries not handed out yet, with the POT each one accounts for
+  std::vector<simb::MCFlux> fBlockFlux;
+  std::vector<double> fBlockPOT;
+  size_t fBlockNext;
+
   // count POT
   double fAccumulatedPOT;
-  double fThisFilePOT;
   
 };
 
@@ -113,18 +117,18 @@ BNBKaonGen::BNBKaonGen(fhicl::ParameterSet const &pset):
 {
   configure(pset);
 
-  // setup indices
-  fFileIndex = 0;
-  fEntry = 0;
-  fEntryStart = 0;
-  fNewFile = true;
-  fFluxTree = NULL;
-  fFluxFile = NULL;
   fDk2Nu = new bsim::Dk2Nu;
   fBooNe = new bsim::BooNe;
 
+  // the BooNE ntuple (tree h101) is read through the stream
+  static const std::vector<std::string> branches {"beamwgt", "ntp", "npart", "id", "ini_pos",
+    "ini_mom", "ini_eng", "ini_t", "fin_mom", "fin_pol"};
+  fFluxStream = std::make_unique<FluxFileStream>(fFluxFiles, fTreeName, branches,
+    fEngine, fTreeCacheSize, fPrefetchFiles, fVerbose,
+    [this](TTree *tree) { fBooNe->SetTree(tree); });
+  fBlockNext = 0;
+
   fAccumulatedPOT = 0.;
-  fThisFilePOT = 0.;
     
 }
 
@@ -133,6 +137,8 @@ BNBKaonGen::BNBKaonGen(fhicl::ParameterSet const &pset):
 BNBKaonGen::~BNBKaonGen()
 {
 
+  // close the files before the objects they read into
+  fFluxStream.reset();
   if (fDk2Nu) delete fDk2Nu;
   if (fBooNe) delete fBooNe;
 }
@@ -148,6 +154,10 @@ void BNBKaonGen::configure(fhicl::ParameterSet const &pset)
   fMetaTreeName = pset.get<std::string>("MetaTreeName");
   fRandomizeFiles = pset.get<bool>("RandomizeFiles");
   fVerbose = pset.get<bool>("Verbose", true);
+  fPrefetchFiles = pset.get<bool>("PrefetchFiles", true);
+  fTreeCacheSize = pset.get<Long64_t>("TreeCacheMB", 32) * 1024 * 1024;
+  fReadBlockSize = pset.get<unsigned>("ReadBlockSize", 64);
+  if (fReadBlockSize == 0) fReadBlockSize = 1;
 
   if(fVerbose){
     std::cout << "Searching for flux files at path: " << fSearchPath << std::endl;
@@ -214,8 +224,8 @@ std::vector<std::string> BNBKaonGen::LoadFluxFiles() {
   return files;
 }
 
-double BNBKaonGen::LoadPOT() {
-  TTreeReader metaReader(fMetaTreeName.c_str(), fFluxFile);
+double BNBKaonGen::LoadPOT(TFile &file) {
+  TTreeReader metaReader(fMetaTreeName.c_str(), &file);
   TTreeReaderValue<double> pot(metaReader, "pots");
   
   double total_pot = 0.;
@@ -235,56 +245,43 @@ double BNBKaonGen::GetPOT() {
 }
 
 const bsim::BooNe *BNBKaonGen::GetNextEntry() {
-  // new file -- set the start entry 
-  if (fNewFile) {
-    // wrap file index around
-    if (fFileIndex >= fFluxFiles.size()) {
-      fFileIndex = 0;
-    }
-    // if (fFileIndex >= fFluxFiles.size()) {
-    //  throw cet::exception("FluxReader Out of Files", 
-    //                       "At file index (" + std::to_string(fFileIndex) + ") of available files (" + std::to_string(fFluxFiles.size()) + ").");
-    // }
-
-    if(fVerbose) std::cout << "New file: " << fFluxFiles[fFileIndex] << " at index: " << fFileIndex << " of: " << fFluxFiles.size() << std::endl;
-    if (fFluxFile) delete fFluxFile;
-    fFluxFile = new TFile(fFluxFiles[fFileIndex].c_str());
-    fFluxTree = (TTree*)fFluxFile->Get(fTreeName.c_str());
-    // fFluxTree->SetBranchAddress("dk2nu",&fDk2Nu);
-    fBooNe = new bsim::BooNe(fFluxFiles[fFileIndex].c_str());
-
-    // Start at a random index in this file
-    fEntryStart = CLHEP::RandFlat::shootInt(fEngine, fFluxTree->GetEntries()-1);
-    fEntry = fEntryStart;
-
-    // load the POT in this file
-    // fThisFilePOT = LoadPOT();
-    fNewFile = false;
-  }
-  else {
-    fEntry = (fEntry + 1) % fFluxTree->GetEntries();
-    // if this is the last entry, get ready for the next file
-    if ((fEntry + 1) % fFluxTree->GetEntries() == fEntryStart) {
-      fFileIndex ++;
-      fNewFile = true;
-    }
-  }
+  fFluxStream->Next();
 
-  // count the POT
-  fBooNe->myNtuple.run    = fEntry;
-  fBooNe->myNtuple.eventn = fFileIndex;
+  fBooNe->myNtuple.run    = fFluxStream->Entry();
+  fBooNe->myNtuple.eventn = fFluxStream->FileIndex();
 
-  fAccumulatedPOT += fBooNe->GetPOT();
-    
-  fFluxTree->GetEntry(fEntry);
-  fBooNe->GetEntry(fEntry);
   return fBooNe;
 }
 
+void BNBKaonGen::ReadBlock() {
+  fBlockFlux.resize(fReadBlockSize);
+  fBlockPOT.resize(fReadBlockSize);
+  for (unsigned i = 0; i < fReadBlockSize; i++) {
+    // const bsim::Dk2Nu *flux = GetNextEntry();
+    const bsim::BooNe *flux = GetNextEntry();
+    fBlockFlux[i] = MakeMCFlux(*flux);
+    fBlockPOT[i] = fBooNe->GetPOT();
+  }
+  fBlockNext = 0;
+}
+
 simb::MCFlux BNBKaonGen::GetNext() {
-  // const bsim::Dk2Nu *flux = GetNextEntry();
-  const bsim::BooNe *flux = GetNextEntry();
-  return MakeMCFlux(*flux);
+  if (fBlockNext >= fBlockFlux.size()) ReadBlock();
+
+  // count the POT
+  fAccumulatedPOT += fBlockPOT[fBlockNext];
+  return fBlockFlux[fBlockNext++];
+}
+
+void BNBKaonGen::GetNextN(size_t n, std::vector<simb::MCFlux> &mesons, std::vector<double> &pot) {
+  mesons.resize(n);
+  pot.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    if (fBlockNext >= fBlockFlux.size()) ReadBlock();
+    fAccumulatedPOT += fBlockPOT[fBlockNext];
+    mesons[i] = std::move(fBlockFlux[fBlockNext++]);
+    pot[i] = GetPOT();
+  }
 }
   
 simb::MCFlux BNBKaonGen::MakeMCFlux(const bsim::BooNe &boone) {
@@ -0,0 +1,233 @@
+/**
+ *  @file   FluxFileStream.h
+ *
+ *  @brief  Sequential reader over a list of flux files, shared by the meson
+ *  generator tools. Each file is read from a random starting entry, wrapping
+ *  around, and the list of files is cycled. While a file is being read, the
+ *  next one is opened on a background thread, and the tree is read through a
+ *  TTreeCache restricted to the branches the tool needs.
+ *
+ */
+#ifndef FluxFileStream_h
+#define FluxFileStream_h
+
+// Framework Includes
+#include "cetlib_except/exception.h"
+
+// Algorithm includes
+#include "CLHEP/Random/RandFlat.h"
+
+// ROOT
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+
+// std includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace evgen
+{
+namespace ldm {
+
+class FluxFileStream
+{
+public:
+  /**
+   *  @param files      flux files, cycled in this order
+   *  @param treeName   name of the flux tree in each file
+   *  @param branches   branches to read (all if empty); the others are disabled.
+   *                    Status is set by branch name, so a split object needs
+   *                    its sub-branches listed, not only its own branch
+   *  @param engine     engine used to draw the starting entry of each file
+   *  @param cacheSize  TTreeCache size in bytes (0 to disable the cache)
+   *  @param prefetch   open the next file on a background thread
+   *  @param bind       called on the main thread with each newly opened tree,
+   *                    to set the branch addresses
+   *  @param loadPOT    optional, called with each newly opened file (possibly
+   *                    from the background thread) to compute the file POT
+   */
+  FluxFileStream(const std::vector<std::string> &files, const std::string &treeName,
+                 const std::vector<std::string> &branches, CLHEP::HepRandomEngine *engine,
+                 Long64_t cacheSize, bool prefetch, bool verbose,
+                 std::function<void(TTree*)> bind,
+                 std::function<double(TFile&)> loadPOT = nullptr):
+    fFiles(files),
+    fTreeName(treeName),
+    fBranches(branches),
+    fEngine(engine),
+    fCacheSize(cacheSize),
+    fPrefetch(prefetch),
+    fVerbose(verbose),
+    fBind(bind),
+    fLoadPOT(loadPOT),
+    fFileIndex(0),
+    fNewFile(true),
+    fPendingIndex(0),
+    fEntry(0),
+    fEntryStart(0),
+    fEntries(0),
+    fNEntriesRead(0),
+    fWaitTime(0.),
+    fReadTime(0.)
+  {
+    if (fFiles.empty()) {
+      throw cet::exception("FluxFileStream") << "No flux files provided.\n";
+    }
+    // files are opened from a second thread
+    if (fPrefetch) ROOT::EnableThreadSafety();
+  }
+
+  ~FluxFileStream() {
+    // let a pending open finish before the file list goes away
+    if (fPending.valid()) fPending.wait();
+
+    if (fVerbose) {
+      std::cout << "FluxFileStream read (" << fNEntriesRead << ") entries. Waited (" << fWaitTime << ") ms on file opens, ("
+                << fReadTime << ") ms reading entries.\n";
+    }
+  }
+
+  FluxFileStream(const FluxFileStream&) = delete;
+  FluxFileStream& operator=(const FluxFileStream&) = delete;
+
+  /// Advance to the next entry, opening the next file when the current one is exhausted, and read it
+  void Next() {
+    if (fNewFile) {
+      NextFile();
+      fNewFile = false;
+    }
+    else {
+      fEntry = (fEntry + 1) % fEntries;
+      // if this is the last entry, get ready for the next file
+      if ((fEntry + 1) % fEntries == fEntryStart) {
+        fFileIndex ++;
+        fNewFile = true;
+      }
+    }
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    fCurrent.tree->GetEntry(fEntry);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    fReadTime += std::chrono::duration<double, std::milli>(t2 - t1).count();
+    fNEntriesRead ++;
+  }
+
+  TTree *Tree() const { return fCurrent.tree; }
+  Long64_t Entry() const { return fEntry; }
+  Long64_t Entries() const { return fEntries; }
+  unsigned FileIndex() const { return fFileIndex; }
+  double FilePOT() const { return fCurrent.pot; }
+
+private:
+  struct OpenFile {
+    std::unique_ptr<TFile> file;
+    TTree *tree = nullptr;
+    double pot = 0.;
+  };
+
+  // Only touches the configuration, so it is safe to run on the background thread
+  OpenFile Open(size_t index) const {
+    OpenFile ret;
+    const std::string &name = fFiles[index];
+    ret.file.reset(TFile::Open(name.c_str()));
+    if (!ret.file || ret.file->IsZombie()) {
+      throw cet::exception("FluxFileStream") << "Could not open flux file: " << name << "\n";
+    }
+    ret.tree = dynamic_cast<TTree*>(ret.file->Get(fTreeName.c_str()));
+    if (!ret.tree) {
+      throw cet::exception("FluxFileStream") << "No tree (" << fTreeName << ") in flux file: " << name << "\n";
+    }
+
+    if (!fBranches.empty()) {
+      ret.tree->SetBranchStatus("*", 0);
+      for (const std::string &b: fBranches) ret.tree->SetBranchStatus(b.c_str(), 1);
+    }
+
+    if (fCacheSize > 0) {
+      ret.tree->SetCacheSize(fCacheSize);
+      if (fBranches.empty()) ret.tree->AddBranchToCache("*", true);
+      for (const std::string &b: fBranches) ret.tree->AddBranchToCache(b.c_str(), true);
+      ret.tree->StopCacheLearningPhase();
+    }
+
+    if (fLoadPOT) ret.pot = fLoadPOT(*ret.file);
+
+    return ret;
+  }
+
+  void NextFile() {
+    // wrap file index around
+    if (fFileIndex >= fFiles.size()) {
+      fFileIndex = 0;
+    }
+
+    if (fVerbose) std::cout << "New file: " << fFiles[fFileIndex] << " at index: " << fFileIndex << " of: " << fFiles.size() << std::endl;
+
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    if (fPending.valid() && fPendingIndex == fFileIndex) {
+      fCurrent = fPending.get();
+    }
+    else {
+      if (fPending.valid()) fPending.wait();
+      fPending = std::future<OpenFile>();
+      fCurrent = Open(fFileIndex);
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    fWaitTime += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+    fBind(fCurrent.tree);
+    fEntries = fCurrent.tree->GetEntries();
+
+    // Start at a random index in this file
+    fEntryStart = CLHEP::RandFlat::shootInt(fEngine, fEntries-1);
+    fEntry = fEntryStart;
+
+    // start opening the file that comes after this one
+    if (fPrefetch && fFiles.size() > 1) {
+      fPendingIndex = (fFileIndex + 1) % fFiles.size();
+      size_t index = fPendingIndex;
+      fPending = std::async(std::launch::async, [this, index]() { return Open(index); });
+    }
+  }
+
+  // config
+  std::vector<std::string> fFiles;
+  std::string fTreeName;
+  std::vector<std::string> fBranches;
+  CLHEP::HepRandomEngine *fEngine;
+  Long64_t fCacheSize;
+  bool fPrefetch;
+  bool fVerbose;
+  std::function<void(TTree*)> fBind;
+  std::function<double(TFile&)> fLoadPOT;
+
+  // info for tracking files
+  unsigned fFileIndex;
+  bool fNewFile;
+  OpenFile fCurrent;
+  std::future<OpenFile> fPending;
+  size_t fPendingIndex;
+
+  // info for tracking entry in file
+  Long64_t fEntry;
+  Long64_t fEntryStart;
+  Long64_t fEntries;
+
+  // I/O accounting
+  uint64_t fNEntriesRead;
+  double fWaitTime;
+  double fReadTime;
+};
+
+} // namespace ldm
+} // namespace evgen
+#endif
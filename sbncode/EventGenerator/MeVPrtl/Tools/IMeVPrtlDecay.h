@@ -23,6 +23,8 @@
 // Algorithm includes
 
 #include <utility>
+#include <array>
+#include <vector>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -43,6 +45,18 @@ public:
 
     virtual bool Decay(const MeVPrtlFlux &flux, const TVector3 &in, const TVector3 &out, MeVPrtlDecay &decay, double &weight) = 0;
 
+    /**
+     *  @brief  Batched Decay over a block of candidates, in order. Only candidates
+     *  with pass[i] set are decayed; pass[i] is then set to the result.
+     */
+    virtual void DecayBatch(const std::vector<MeVPrtlFlux> &flux, const std::vector<std::array<TVector3, 2>> &intersect, std::vector<MeVPrtlDecay> &decay, std::vector<double> &weight, std::vector<char> &pass) {
+      decay.resize(flux.size());
+      weight.resize(flux.size());
+      for (size_t i = 0; i < flux.size(); i++) {
+        if (pass[i]) pass[i] = Decay(flux[i], intersect[i][0], intersect[i][1], decay[i], weight[i]);
+      }
+    }
+
 protected:
     double TimeOfFlight(const MeVPrtlFlux &flux, TVector3 decay);
 };
@@ -25,6 +25,8 @@
 #include "IMeVPrtlStage.h"
 #include "Constants.h"
 
+#include <vector>
+
 // Algorithm includes
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -46,6 +48,18 @@ public:
 
     virtual bool MakeFlux(const simb::MCFlux &mcflux, MeVPrtlFlux &flux, double &weight) = 0;
 
+    /**
+     *  @brief  Batched MakeFlux over a block of candidates, in order. Only candidates
+     *  with pass[i] set are processed; pass[i] is then set to the MakeFlux result.
+     */
+    virtual void MakeFluxBatch(const std::vector<simb::MCFlux> &mcflux, std::vector<MeVPrtlFlux> &flux, std::vector<double> &weight, std::vector<char> &pass) {
+      flux.resize(mcflux.size());
+      weight.resize(mcflux.size());
+      for (size_t i = 0; i < mcflux.size(); i++) {
+        if (pass[i]) pass[i] = MakeFlux(mcflux[i], flux[i], weight[i]);
+      }
+    }
+
     IMeVPrtlFlux(const fhicl::ParameterSet &pset)
     {
       fVerbose = pset.get<bool>("Verbose", true);
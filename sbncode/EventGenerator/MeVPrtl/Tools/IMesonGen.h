@@ -18,6 +18,8 @@
 
 #include "IMeVPrtlStage.h"
 
+#include <vector>
+
 // Algorithm includes
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -39,6 +41,20 @@ public:
     virtual simb::MCFlux GetNext() = 0;
     virtual double GetPOT() = 0;
 
+    /**
+     *  @brief  Source the next n mesons in one call. pot[i] is the POT accumulated
+     *  while sourcing mesons[i], so summing pot over any run of candidates gives
+     *  what GetPOT() would have returned after them.
+     */
+    virtual void GetNextN(size_t n, std::vector<simb::MCFlux> &mesons, std::vector<double> &pot) {
+      mesons.resize(n);
+      pot.resize(n);
+      for (size_t i = 0; i < n; i++) {
+        mesons[i] = GetNext();
+        pot[i] = GetPOT();
+      }
+    }
+
 };
 
 } // namespace ldm
@@ -45,6 +45,18 @@ public:
     virtual ~IRayTrace() noexcept = default;
 
     virtual bool IntersectDetector(MeVPrtlFlux &flux, std::array<TVector3, 2> &intersect, double &weight) = 0;
+
+    /**
+     *  @brief  Batched IntersectDetector over a block of candidates, in order. Only
+     *  candidates with pass[i] set are traced; pass[i] is then set to the result.
+     */
+    virtual void IntersectDetectorBatch(std::vector<MeVPrtlFlux> &flux, std::vector<std::array<TVector3, 2>> &intersect, std::vector<double> &weight, std::vector<char> &pass) {
+      intersect.resize(flux.size());
+      weight.resize(flux.size());
+      for (size_t i = 0; i < flux.size(); i++) {
+        if (pass[i]) pass[i] = IntersectDetector(flux[i], intersect[i], weight[i]);
+      }
+    }
 };
 
 } // namespace ldm
@@ -16,6 +16,7 @@
 #include "IRayTrace.h"
 #include "sbnobj/Common/EventGen/MeVPrtl/MeVPrtlFlux.h"
 #include "sbncode/EventGenerator/MeVPrtl/Tools/Constants.h"
+#include "sbncode/EventGenerator/MeVPrtl/Tools/RayTraceSlab.h"
 
 // LArSoft includes
 #include "larcorealg/Geometry/BoxBoundedGeo.h"
@@ -29,6 +30,9 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <array>
+#include <vector>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // implementation follows
@@ -39,8 +43,9 @@ namespace ldm {
 
 // Helper struct retruned by some internal functions
 struct RayWeightInfo {
-  std::vector<std::vector<TVector3>> allIntersections;
   std::vector<TLorentzVector> allPrtlMom;
+  // line parameters of the box crossings along each (unit) portal direction
+  std::vector<std::array<double, 2>> allT;
   double weight;
   bool pass;
 };
@@ -72,6 +77,7 @@ public:
 
 private:
   geo::BoxBoundedGeo fBox;
+  SlabBox fSlabBox;
   double fReferenceLabSolidAngle;
   double fReferencePrtlMass;
   int fReferenceScndPDG;
@@ -87,12 +93,16 @@ private:
 
   double fMaxWeight;
 
+  // reused across candidates
+  RayWeightInfo fInfo;
+
   void CalculateMaxWeight();
   std::pair<double, double> DeltaPhi(TVector3 origin, TRotation &R);
-  TLorentzVector ThrowMeVPrtlMomentum(const MeVPrtlFlux &flux, TRotation &RInv, double phi);
-  RayWeightInfo ThrowFixedSuccess(const MeVPrtlFlux &flux, TRotation &RInv, double phi);
-  RayWeightInfo ThrowFixedThrows(const MeVPrtlFlux &flux, TRotation &RInv, double phi);
-  RayWeightInfo NoThrow(const MeVPrtlFlux &flux, TRotation &RInv, double phi);
+  TLorentzVector PrtlMomentum(const MeVPrtlFlux &flux, TRotation &RInv, double phi, double costh);
+  unsigned ThrowBlock(const MeVPrtlFlux &flux, TRotation &RInv, double phi, unsigned n, RayWeightInfo &ret);
+  void ThrowFixedSuccess(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret);
+  void ThrowFixedThrows(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret);
+  void NoThrow(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret);
 };
 
 // Helpers
@@ -131,6 +141,7 @@ void MixedWeightRayTraceBox::configure(fhicl::ParameterSet const &pset)
     const geo::GeometryCore *geometry = lar::providerFrom<geo::Geometry>();
     fBox = geometry->DetectorEnclosureBox(pset.get<std::string>("Volume"));
   }
+  fSlabBox = SlabBox(fBox);
 
   if (fVerbose){
     std::cout << "Detector Box." << std::endl;
@@ -200,9 +211,8 @@ void MixedWeightRayTraceBox::CalculateMaxWeight() {
   fMaxWeight = std::min(fMaxWeightFudge * weight * fReferenceLabSolidAngle / (4*M_PI), 1.);
 }
 
-TLorentzVector MixedWeightRayTraceBox::ThrowMeVPrtlMomentum(const MeVPrtlFlux &flux, TRotation &RInv, double phi) {
-  // Pick a direction vector with the parent-direction along the z-axis
-  double costh = GetRandom()*2 - 1.;
+TLorentzVector MixedWeightRayTraceBox::PrtlMomentum(const MeVPrtlFlux &flux, TRotation &RInv, double phi, double costh) {
+  // Direction vector with the parent-direction along the z-axis
   double sinth = sqrt(1 - costh*costh);
 
   TVector3 dir(cos(phi)*sinth, sin(phi)*sinth, costh);
@@ -224,7 +234,8 @@ TLorentzVector MixedWeightRayTraceBox::ThrowMeVPrtlMomentum(const MeVPrtlFlux &f
 std::pair<double, double> MixedWeightRayTraceBox::DeltaPhi(TVector3 origin, TRotation &R) {
   // If the parent hits the detector, then delta-phi is 2Pi 
   TVector3 pdir = R.Inverse()*TVector3(0, 0, 1);
-  if (fBox.GetIntersections(origin, pdir).size()) {
+  double tin, tout;
+  if (SlabIntersect(fSlabBox, origin, pdir, tin, tout)) {
     if (fVerbose) std::cout << "Parent Direction: " << pdir.X() << " " << pdir.Y() << " " << pdir.Z() << " at location: " << origin.X() << " " << origin.Y() << " " << origin.Z() << " hits detector!\n";
     return {-M_PI, M_PI};
   }
@@ -261,37 +272,58 @@ std::pair<double, double> MixedWeightRayTraceBox::DeltaPhi(TVector3 origin, TRot
   return {philo, phihi};
 }
 
-RayWeightInfo MixedWeightRayTraceBox::ThrowFixedThrows(const MeVPrtlFlux &flux, TRotation &RInv, double phi) {
-  RayWeightInfo ret;
-  unsigned ithrow = 0;
-  unsigned nfail = 0;
-  unsigned nsuccess = 0;
-
-  while (ithrow < fNThrow) {
-    ithrow ++;
+unsigned MixedWeightRayTraceBox::ThrowBlock(const MeVPrtlFlux &flux, TRotation &RInv, double phi, unsigned n, RayWeightInfo &ret) {
+  // Throw n rest-frame angles at once and trace them against the box in one pass.
+  // Randoms are drawn in the same order as one throw at a time.
+  double costh[kRaySlabBlock];
+  for (unsigned i = 0; i < n; i++) costh[i] = GetRandom()*2 - 1.;
+
+  // Rest-frame direction, rotated to the lab axes
+  RayBlock block;
+  block.n = n;
+  double cphi = cos(phi);
+  double sphi = sin(phi);
+  for (unsigned i = 0; i < n; i++) {
+    double sinth = sqrt(1 - costh[i]*costh[i]);
+    double x = cphi*sinth;
+    double y = sphi*sinth;
+    double z = costh[i];
+    block.dx[i] = RInv.XX()*x + RInv.XY()*y + RInv.XZ()*z;
+    block.dy[i] = RInv.YX()*x + RInv.YY()*y + RInv.YZ()*z;
+    block.dz[i] = RInv.ZX()*x + RInv.ZY()*y + RInv.ZZ()*z;
+  }
 
-    TLorentzVector mevprtl_mom = ThrowMeVPrtlMomentum(flux, RInv, phi);
-    std::vector<TVector3> box_intersections = fBox.GetIntersections(flux.pos.Vect(), mevprtl_mom.Vect().Unit());
+  // Boost to the lab
+  TLorentzVector mevprtl_rest = flux.mom;
+  mevprtl_rest.Boost(-flux.mmom.BoostVector());
+  BoostDirections(block, mevprtl_rest.P(), mevprtl_rest.E(), flux.mmom.BoostVector());
 
-    // Does this ray intersect the box?
-    if (box_intersections.size() != 2) {
-      nfail ++;
-      continue;
-    }
+  SlabIntersect(fSlabBox, flux.pos.Vect(), block);
 
-    // if the ray points the wrong way, it doesn't intersect
-    TVector3 A = box_intersections[0];
-    if (mevprtl_mom.Vect().Unit().Dot((A - flux.pos.Vect()).Unit()) < 0.) {
-      nfail ++;
-      continue;
-    }
+  unsigned nsuccess = 0;
+  for (unsigned i = 0; i < n; i++) {
+    // Does this ray intersect the box, and point towards it?
+    if (!SlabHit(block.tin[i], block.tout[i])) continue;
 
     // if we're here, we have a valid ray
-    ret.allIntersections.push_back(box_intersections);
-    ret.allPrtlMom.push_back(mevprtl_mom);
+    ret.allPrtlMom.push_back(PrtlMomentum(flux, RInv, phi, costh[i]));
+    ret.allT.push_back({block.tin[i], block.tout[i]});
     nsuccess ++;
   }
 
+  return nsuccess;
+}
+
+void MixedWeightRayTraceBox::ThrowFixedThrows(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret) {
+  unsigned ithrow = 0;
+  unsigned nsuccess = 0;
+
+  while (ithrow < fNThrow) {
+    unsigned n = std::min(fNThrow - ithrow, kRaySlabBlock);
+    nsuccess += ThrowBlock(flux, RInv, phi, n, ret);
+    ithrow += n;
+  }
+
   if (fVerbose) {
     std::cout << "NTHROW: " << fNThrow << std::endl;
     std::cout << "NSUCCESS: " << nsuccess << std::endl;
@@ -300,14 +332,9 @@ RayWeightInfo MixedWeightRayTraceBox::ThrowFixedThrows(const MeVPrtlFlux &flux,
 
   ret.weight = ((double)nsuccess) / fNThrow;
   ret.pass = nsuccess > 0;
-
-  return ret;
-
 }
 
-RayWeightInfo MixedWeightRayTraceBox::NoThrow(const MeVPrtlFlux &flux, TRotation &RInv, double phi) {
-  RayWeightInfo ret;
-
+void MixedWeightRayTraceBox::NoThrow(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret) {
   // Rotate the flux momentum to the specified phi
   TLorentzVector mevprtl_mom = flux.mom;
   // Go to frame where parent direction is along z
@@ -317,47 +344,28 @@ RayWeightInfo MixedWeightRayTraceBox::NoThrow(const MeVPrtlFlux &flux, TRotation
   // Go back
   mevprtl_mom.Transform(RInv);
 
-  std::vector<TVector3> box_intersections = fBox.GetIntersections(flux.pos.Vect(), mevprtl_mom.Vect().Unit());
-  ret.pass = (box_intersections.size() == 2) && // ray intersects detector
-    (mevprtl_mom.Vect().Unit().Dot((box_intersections[0] - flux.pos.Vect()).Unit()) > 0.); // and points at detector
+  double tin, tout;
+  SlabIntersect(fSlabBox, flux.pos.Vect(), mevprtl_mom.Vect().Unit(), tin, tout);
+  ret.pass = SlabHit(tin, tout); // ray intersects detector and points at it
   if (ret.pass) {
-    ret.allIntersections.push_back(box_intersections);
     ret.allPrtlMom.push_back(mevprtl_mom);
+    ret.allT.push_back({tin, tout});
   } 
 
   ret.weight = 1.;
-  return ret;
 }
 
-RayWeightInfo MixedWeightRayTraceBox::ThrowFixedSuccess(const MeVPrtlFlux &flux, TRotation &RInv, double phi) {
-  RayWeightInfo ret;
+void MixedWeightRayTraceBox::ThrowFixedSuccess(const MeVPrtlFlux &flux, TRotation &RInv, double phi, RayWeightInfo &ret) {
   unsigned ithrow = 0;
-  unsigned nfail = 0;
   unsigned nsuccess = 0;
   while (nsuccess < fNSuccess && ithrow < fNThrow) {
-    ithrow ++;
-
-    TLorentzVector mevprtl_mom = ThrowMeVPrtlMomentum(flux, RInv, phi);
-    std::vector<TVector3> box_intersections = fBox.GetIntersections(flux.pos.Vect(), mevprtl_mom.Vect().Unit());
-
-    // Does this ray intersect the box?
-    if (box_intersections.size() != 2) {
-      nfail ++;
-      continue;
-    }
-
-    // if the ray points the wrong way, it doesn't intersect
-    TVector3 A = box_intersections[0];
-    if (mevprtl_mom.Vect().Unit().Dot((A - flux.pos.Vect()).Unit()) < 0.) {
-      nfail ++;
-      continue;
-    }
-
-    // if we're here, we have a valid ray
-    ret.allIntersections.push_back(box_intersections);
-    ret.allPrtlMom.push_back(mevprtl_mom);
-    nsuccess ++;
+    // Each throw adds at most one success, so a block of this size never throws
+    // past the point where the one-at-a-time loop would have stopped
+    unsigned n = std::min({fNSuccess - nsuccess, fNThrow - ithrow, kRaySlabBlock});
+    nsuccess += ThrowBlock(flux, RInv, phi, n, ret);
+    ithrow += n;
   }
+  unsigned nfail = ithrow - nsuccess;
 
   if (fVerbose){
     std::cout << "NFAIL: " << nfail << std::endl;
@@ -373,8 +381,6 @@ RayWeightInfo MixedWeightRayTraceBox::ThrowFixedSuccess(const MeVPrtlFlux &flux,
     ret.weight = 0.;
     ret.pass = false;
   }
-
-  return ret;
 }
 
 bool MixedWeightRayTraceBox::IntersectDetector(MeVPrtlFlux &flux, std::array<TVector3, 2> &intersection, double &weight) {
@@ -436,17 +442,21 @@ bool MixedWeightRayTraceBox::IntersectDetector(MeVPrtlFlux &flux, std::array<TVe
     std::cout << "THISPHI: " << phi << std::endl;
   }
 
-  RayWeightInfo info = (!fRethrowTheta) ? NoThrow(flux, RInv, phi) : 
-                                          ((fFixNSuccess) ? ThrowFixedSuccess(flux, RInv, phi) : ThrowFixedThrows(flux, RInv, phi));
+  RayWeightInfo &info = fInfo;
+  info.allPrtlMom.clear();
+  info.allT.clear();
+  if (!fRethrowTheta) NoThrow(flux, RInv, phi, info);
+  else if (fFixNSuccess) ThrowFixedSuccess(flux, RInv, phi, info);
+  else ThrowFixedThrows(flux, RInv, phi, info);
 
   if (!info.pass) return false;
 
-  unsigned ind = CLHEP::RandFlat::shootInt(fEngine, 0, info.allIntersections.size()-1); // inclusive?
+  unsigned ind = CLHEP::RandFlat::shootInt(fEngine, 0, info.allPrtlMom.size()-1); // inclusive?
   TLorentzVector mevprtl_mom = info.allPrtlMom[ind];
-  std::vector<TVector3> box_intersections = info.allIntersections[ind];
 
-  TVector3 A = box_intersections[0];
-  TVector3 B = box_intersections[1];
+  TVector3 mevprtl_dir = mevprtl_mom.Vect().Unit();
+  TVector3 A = info.allT[ind][0] * mevprtl_dir + flux.pos.Vect();
+  TVector3 B = info.allT[ind][1] * mevprtl_dir + flux.pos.Vect();
 
   // make sure that the flux start lies outside the detector
   if ((flux.pos.Vect() - A).Mag() < (A-B).Mag() && (flux.pos.Vect() - B).Mag() < (A-B).Mag()) {
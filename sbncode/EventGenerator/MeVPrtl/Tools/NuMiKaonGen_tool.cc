@@ -19,6 +19,7 @@
 
 // local includes
 #include "IMesonGen.h"
+#include "FluxFileStream.h"
 
 // LArSoft includes
 #include "dk2nu/tree/dk2nu.h"
@@ -60,13 +61,17 @@ public:
 
     double GetPOT() override;
     simb::MCFlux GetNext() override;
+    void GetNextN(size_t n, std::vector<simb::MCFlux> &mesons, std::vector<double> &pot) override;
 
     void configure(const fhicl::ParameterSet&) override;
 
     const bsim::Dk2Nu *GetNextEntry();
     std::vector<std::string> LoadFluxFiles();
     simb::MCFlux MakeMCFlux(const bsim::Dk2Nu &dk2nu);
-    double LoadPOT();
+    double LoadPOT(TFile &file);
+
+    // decode the next block of entries
+    void ReadBlock();
 
     // no weights
     double MaxWeight() override { return -1.; }
@@ -81,24 +86,23 @@ private:
 
   std::string fTreeName;
   std::string fMetaTreeName;
+  bool fPrefetchFiles;
+  Long64_t fTreeCacheSize;
+  unsigned fReadBlockSize;
 
-  // info for tracking files
-  unsigned fFileIndex;
-  bool fNewFile;
   std::vector<std::string> fFluxFiles;
 
-  // info for tracking entry in file
-  unsigned fEntry;
-  unsigned fEntryStart;
-
   // ROOT Holders
-  TTree *fFluxTree;
-  TFile *fFluxFile;
+  std::unique_ptr<FluxFileStream> fFluxStream;
   bsim::Dk2Nu *fDk2Nu;
 
+  // decoded entries not handed out yet, with the POT each one accounts for
+  std::vector<simb::MCFlux> fBlockFlux;
+  std::vector<double> fBlockPOT;
+  size_t fBlockNext;
+
   // count POT
   double fAccumulatedPOT;
-  double fThisFilePOT;
   
 };
 
@@ -110,17 +114,16 @@ NuMiKaonGen::NuMiKaonGen(fhicl::ParameterSet const &pset):
   // copy the flux files locally
   fFluxFiles = LoadFluxFiles();
 
-  // setup indices
-  fFileIndex = 0;
-  fEntry = 0;
-  fEntryStart = 0;
-  fNewFile = true;
-  fFluxTree = NULL;
-  fFluxFile = NULL;
   fDk2Nu = new bsim::Dk2Nu;
+  // The dk2nu object is split into sub-branches (job, decay, ancestor, ...) that
+  // SetBranchStatus does not reach through "dk2nu": keep every branch enabled
+  fFluxStream = std::make_unique<FluxFileStream>(fFluxFiles, fTreeName, std::vector<std::string>{},
+    fEngine, fTreeCacheSize, fPrefetchFiles, true,
+    [this](TTree *tree) { tree->SetBranchAddress("dk2nu",&fDk2Nu); },
+    [this](TFile &file) { return LoadPOT(file); });
+  fBlockNext = 0;
 
   fAccumulatedPOT = 0.;
-  fThisFilePOT = 0.;
     
 }
 
@@ -129,6 +132,8 @@ NuMiKaonGen::NuMiKaonGen(fhicl::ParameterSet const &pset):
 NuMiKaonGen::~NuMiKaonGen()
 {
 
+  // close the files before the object they read into
+  fFluxStream.reset();
   if (fDk2Nu) delete fDk2Nu;
 }
 
@@ -142,6 +147,10 @@ void NuMiKaonGen::configure(fhicl::ParameterSet const &pset)
   fTreeName = pset.get<std::string>("TreeName");
   fMetaTreeName = pset.get<std::string>("MetaTreeName");
   fRandomizeFiles = pset.get<bool>("RandomizeFiles");
+  fPrefetchFiles = pset.get<bool>("PrefetchFiles", true);
+  fTreeCacheSize = pset.get<Long64_t>("TreeCacheMB", 32) * 1024 * 1024;
+  fReadBlockSize = pset.get<unsigned>("ReadBlockSize", 64);
+  if (fReadBlockSize == 0) fReadBlockSize = 1;
 
   std::cout << "Searching for flux files at path: " << fSearchPath << std::endl;
   std::cout << "With patterns:\n";
@@ -204,8 +213,8 @@ std::vector<std::string> NuMiKaonGen::LoadFluxFiles() {
   return files;
 }
 
-double NuMiKaonGen::LoadPOT() {
-  TTreeReader metaReader(fMetaTreeName.c_str(), fFluxFile);
+double NuMiKaonGen::LoadPOT(TFile &file) {
+  TTreeReader metaReader(fMetaTreeName.c_str(), &file);
   TTreeReaderValue<double> pot(metaReader, "pots");
   
   double total_pot = 0.;
@@ -225,50 +234,38 @@ double NuMiKaonGen::GetPOT() {
 }
 
 const bsim::Dk2Nu *NuMiKaonGen::GetNextEntry() {
-  // new file -- set the start entry 
-  if (fNewFile) {
-    // wrap file index around
-    if (fFileIndex >= fFluxFiles.size()) {
-      fFileIndex = 0;
-    }
-    // if (fFileIndex >= fFluxFiles.size()) {
-    //  throw cet::exception("FluxReader Out of Files", 
-    //                       "At file index (" + std::to_string(fFileIndex) + ") of available files (" + std::to_string(fFluxFiles.size()) + ").");
-    // }
-
-    std::cout << "New file: " << fFluxFiles[fFileIndex] << " at index: " << fFileIndex << " of: " << fFluxFiles.size() << std::endl;
-    if (fFluxFile) delete fFluxFile;
-    fFluxFile = new TFile(fFluxFiles[fFileIndex].c_str());
-    fFluxTree = (TTree*)fFluxFile->Get(fTreeName.c_str());
-    fFluxTree->SetBranchAddress("dk2nu",&fDk2Nu);
-
-    // Start at a random index in this file
-    fEntryStart = CLHEP::RandFlat::shootInt(fEngine, fFluxTree->GetEntries()-1);
-    fEntry = fEntryStart;
-
-    // load the POT in this file
-    fThisFilePOT = LoadPOT();
-    fNewFile = false;
-  }
-  else {
-    fEntry = (fEntry + 1) % fFluxTree->GetEntries();
-    // if this is the last entry, get ready for the next file
-    if ((fEntry + 1) % fFluxTree->GetEntries() == fEntryStart) {
-      fFileIndex ++;
-      fNewFile = true;
-    }
+  fFluxStream->Next();
+  return fDk2Nu;
+}
+
+void NuMiKaonGen::ReadBlock() {
+  fBlockFlux.resize(fReadBlockSize);
+  fBlockPOT.resize(fReadBlockSize);
+  for (unsigned i = 0; i < fReadBlockSize; i++) {
+    const bsim::Dk2Nu *flux = GetNextEntry();
+    fBlockFlux[i] = MakeMCFlux(*flux);
+    fBlockPOT[i] = fFluxStream->FilePOT() / fFluxStream->Entries();
   }
+  fBlockNext = 0;
+}
+
+simb::MCFlux NuMiKaonGen::GetNext() {
+  if (fBlockNext >= fBlockFlux.size()) ReadBlock();
 
   // count the POT
-  fAccumulatedPOT += fThisFilePOT / fFluxTree->GetEntries();
-    
-  fFluxTree->GetEntry(fEntry);
-  return fDk2Nu;
+  fAccumulatedPOT += fBlockPOT[fBlockNext];
+  return fBlockFlux[fBlockNext++];
 }
 
-simb::MCFlux NuMiKaonGen::GetNext() {
-  const bsim::Dk2Nu *flux = GetNextEntry();
-  return MakeMCFlux(*flux);
+void NuMiKaonGen::GetNextN(size_t n, std::vector<simb::MCFlux> &mesons, std::vector<double> &pot) {
+  mesons.resize(n);
+  pot.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    if (fBlockNext >= fBlockFlux.size()) ReadBlock();
+    fAccumulatedPOT += fBlockPOT[fBlockNext];
+    mesons[i] = std::move(fBlockFlux[fBlockNext++]);
+    pot[i] = GetPOT();
+  }
 }
   
 simb::MCFlux NuMiKaonGen::MakeMCFlux(const bsim::Dk2Nu &dk2nu) {
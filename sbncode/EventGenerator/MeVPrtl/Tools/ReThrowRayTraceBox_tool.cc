@@ -16,6 +16,7 @@
 #include "IRayTrace.h"
 #include "sbnobj/Common/EventGen/MeVPrtl/MeVPrtlFlux.h"
 #include "sbncode/EventGenerator/MeVPrtl/Tools/Constants.h"
+#include "sbncode/EventGenerator/MeVPrtl/Tools/RayTraceSlab.h"
 
 // LArSoft includes
 #include "larcorealg/Geometry/BoxBoundedGeo.h"
@@ -27,6 +28,9 @@
 #include <string>
 #include <iostream>
 #include <memory>
+#include <algorithm>
+#include <array>
+#include <vector>
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 // implementation follows
@@ -53,7 +57,7 @@ public:
 
     bool IntersectDetector(MeVPrtlFlux &flux, std::array<TVector3, 2> &intersection, double &weight) override;
 
-    TLorentzVector ThrowMeVPrtlMomentum(const MeVPrtlFlux &flux);
+    TLorentzVector PrtlMomentum(const MeVPrtlFlux &flux, const TVector3 &dir);
 
     // always thrown at least once
     double MaxWeight() override { 
@@ -62,6 +66,7 @@ public:
 
 private:
   geo::BoxBoundedGeo fBox;
+  SlabBox fSlabBox;
   unsigned fNThrows;
   bool fVerbose;
 
@@ -74,6 +79,10 @@ private:
   void CalculateMaxWeight();
 
   double fMaxWeight;
+
+  // successful throws, reused across candidates
+  std::vector<TLorentzVector> fAllHMom;
+  std::vector<std::array<double, 2>> fAllT;
 };
 
 ReThrowRayTraceBox::ReThrowRayTraceBox(fhicl::ParameterSet const &pset):
@@ -102,6 +111,7 @@ void ReThrowRayTraceBox::configure(fhicl::ParameterSet const &pset)
     const geo::GeometryCore *geometry = lar::providerFrom<geo::Geometry>();
     fBox = geometry->DetectorEnclosureBox(pset.get<std::string>("Volume"));
   }
+  fSlabBox = SlabBox(fBox);
 
   fNThrows = pset.get<unsigned>("NThrows", 10000);
 
@@ -140,10 +150,7 @@ void ReThrowRayTraceBox::CalculateMaxWeight() {
   fMaxWeight = scale * fReferenceLabSolidAngle;
 }
 
-TLorentzVector ReThrowRayTraceBox::ThrowMeVPrtlMomentum(const MeVPrtlFlux &flux) {
-  // pick a direction for the rest-frame
-  TVector3 dir = RandomUnitVector();
-
+TLorentzVector ReThrowRayTraceBox::PrtlMomentum(const MeVPrtlFlux &flux, const TVector3 &dir) {
   // make the mevprtl momentum this
   // 
   // Move the mevprtl momentum back to the kaon rest frame
@@ -161,48 +168,65 @@ TLorentzVector ReThrowRayTraceBox::ThrowMeVPrtlMomentum(const MeVPrtlFlux &flux)
     
 bool ReThrowRayTraceBox::IntersectDetector(MeVPrtlFlux &flux, std::array<TVector3, 2> &intersection, double &weight) {
   // try out the mevprtl direction a bunch of times
-  std::vector<std::vector<TVector3>> allIntersections;
-  std::vector<TLorentzVector> allHMom;
-
-  for (unsigned i = 0; i <= fNThrows; i++) {
-    TLorentzVector mevprtl_mom = ThrowMeVPrtlMomentum(flux);
-    std::vector<TVector3> box_intersections = fBox.GetIntersections(flux.pos.Vect(), mevprtl_mom.Vect().Unit());
-
-    // Does this ray intersect the box?
-    if (box_intersections.size() != 2) {
-      continue;
+  //
+  // Directions are thrown in blocks and traced against the box in one pass.
+  // Randoms are drawn in the same order as one throw at a time.
+  fAllHMom.clear();
+  fAllT.clear();
+
+  TLorentzVector mevprtl_rest = flux.mom;
+  mevprtl_rest.Boost(-flux.mmom.BoostVector());
+
+  TVector3 dirs[kRaySlabBlock];
+  RayBlock block;
+  unsigned ithrow = 0;
+  while (ithrow <= fNThrows) {
+    block.n = std::min(fNThrows + 1 - ithrow, kRaySlabBlock);
+    for (unsigned i = 0; i < block.n; i++) {
+      // pick a direction for the rest-frame
+      dirs[i] = RandomUnitVector();
+      block.dx[i] = dirs[i].X();
+      block.dy[i] = dirs[i].Y();
+      block.dz[i] = dirs[i].Z();
     }
-
-    TVector3 A = box_intersections[0];
-
-    // if the ray points the wrong way, it doesn't intersect
-    if (mevprtl_mom.Vect().Unit().Dot((A - flux.pos.Vect()).Unit()) < 0.) {
-      std::cerr << "RAYTRACE: MeVPrtl points wrong way" << std::endl;
-      std::cerr << "Pos: " << flux.pos.X() << " " << flux.pos.Y() << " " << flux.pos.Z() << std::endl;
-      std::cerr << "A: " << A.X() << " " << A.Y() << " " << A.Z() << std::endl;
-      std::cerr << "P: " << mevprtl_mom.Vect().Unit().X() << " " << mevprtl_mom.Vect().Unit().Y() << " " << mevprtl_mom.Vect().Unit().Z() << std::endl;
-      continue;
+    ithrow += block.n;
+
+    BoostDirections(block, mevprtl_rest.P(), mevprtl_rest.E(), flux.mmom.BoostVector());
+    SlabIntersect(fSlabBox, flux.pos.Vect(), block);
+
+    for (unsigned i = 0; i < block.n; i++) {
+      // Does this ray intersect the box?
+      if (!(block.tin[i] < block.tout[i])) continue;
+
+      // if the ray points the wrong way, it doesn't intersect
+      if (block.tin[i] < 0.) {
+        std::cerr << "RAYTRACE: MeVPrtl points wrong way" << std::endl;
+        std::cerr << "Pos: " << flux.pos.X() << " " << flux.pos.Y() << " " << flux.pos.Z() << std::endl;
+        std::cerr << "A: " << (flux.pos.X() + block.tin[i]*block.dx[i]) << " " << (flux.pos.Y() + block.tin[i]*block.dy[i]) << " " << (flux.pos.Z() + block.tin[i]*block.dz[i]) << std::endl;
+        std::cerr << "P: " << block.dx[i] << " " << block.dy[i] << " " << block.dz[i] << std::endl;
+        continue;
+      }
+
+      // if we're here, we have a valid ray
+      fAllHMom.push_back(PrtlMomentum(flux, dirs[i]));
+      fAllT.push_back({block.tin[i], block.tout[i]});
     }
-
-    // if we're here, we have a valid ray
-    allIntersections.push_back(box_intersections);
-    allHMom.push_back(mevprtl_mom);
   }
 
-  if (fVerbose) std::cout << "Prtl intersected (" << allIntersections.size() << " / " << fNThrows << ") times.\n";
+  if (fVerbose) std::cout << "Prtl intersected (" << fAllHMom.size() << " / " << fNThrows << ") times.\n";
 
   // did we get a hit?
-  if (allIntersections.size() == 0) {
+  if (fAllHMom.size() == 0) {
     return false;
   }
 
-  unsigned ind = CLHEP::RandFlat::shootInt(fEngine, 0, allIntersections.size()-1); // inclusive?
+  unsigned ind = CLHEP::RandFlat::shootInt(fEngine, 0, fAllHMom.size()-1); // inclusive?
 
-  TLorentzVector mevprtl_mom = allHMom[ind];
-  std::vector<TVector3> box_intersections = allIntersections[ind];
+  TLorentzVector mevprtl_mom = fAllHMom[ind];
 
-  TVector3 A = box_intersections[0];
-  TVector3 B = box_intersections[1];
+  TVector3 mevprtl_dir = mevprtl_mom.Vect().Unit();
+  TVector3 A = fAllT[ind][0] * mevprtl_dir + flux.pos.Vect();
+  TVector3 B = fAllT[ind][1] * mevprtl_dir + flux.pos.Vect();
 
   // make sure that the flux start lies outside the detector
   if ((flux.pos.Vect() - A).Mag() < (A-B).Mag() && (flux.pos.Vect() - B).Mag() < (A-B).Mag()) {
@@ -214,7 +238,7 @@ bool ReThrowRayTraceBox::IntersectDetector(MeVPrtlFlux &flux, std::array<TVector
   } 
 
   // set things
-  weight = (double)allIntersections.size() / fNThrows;
+  weight = (double)fAllHMom.size() / fNThrows;
   flux.mom = mevprtl_mom;
   // transform to beam-coord frame
   flux.mom_beamcoord = mevprtl_mom;
@@ -56,6 +56,13 @@ struct BooNENtuple
             myTree->GetEntry(entry);
         }
 
+        // Read the ntuple from a tree opened elsewhere (e.g. by a FluxFileStream)
+        void SetTree(TTree *tree)
+        {
+            myTree = tree;
+            SetBranchAddresses();
+        }
+
         float GetPOT()
         {//Returns the POT/entry (meant to be accumulated on each iteration)
             return POT / myTree->GetEntries();
@@ -83,6 +90,12 @@ struct BooNENtuple
                 myFile->ls();
             myTree = dynamic_cast<TTree *>(myFile->Get("h101"));
 
+            SetBranchAddresses();
+            myTree->GetEntry(0);
+        };
+
+        void SetBranchAddresses()
+        {
             myTree->SetBranchAddress("beamwgt", &myNtuple.beamwgt);
             myTree->SetBranchAddress("ntp", &myNtuple.ntp);
             myTree->SetBranchAddress("npart", &myNtuple.npart);
@@ -93,7 +106,6 @@ struct BooNENtuple
             myTree->SetBranchAddress("ini_t", myNtuple.ini_t);
             myTree->SetBranchAddress("fin_mom", &myNtuple.fin_mom[0][0]);
             myTree->SetBranchAddress("fin_pol", &myNtuple.fin_pol[0][0]);
-            myTree->GetEntry(0);
         };
     };
 }
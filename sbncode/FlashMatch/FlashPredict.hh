@@ -45,6 +45,7 @@
 #include "TH1.h"
 #include "TH2.h"
 #include "TProfile3D.h"
+#include "TRandom.h"
 
 #include "sbncode/OpT0Finder/flashmatch/Base/OpT0FinderTypes.h"
 #include "sbncode/OpDet/PDMapAlg.h"
@@ -54,6 +55,8 @@
 #include "nusimdata/SimulationBase/MCTruth.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <iterator>
 #include <limits>
 #include <list>
@@ -61,6 +64,7 @@
 #include <set>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 
 class FlashPredict;
 class FlashPredict : public art::EDProducer {
@@ -81,6 +85,81 @@ public:
   void beginJob() override;
   void endJob() override;
 
+  // X projections of a metric vs X histogram (RRH2, RatioH2), one per
+  // Y bin including under/overflow, over the narrowest Y window around
+  // that bin holding more than kMinEntriesInProjection entries.
+  // Built once in loadMetrics(), used by xEstimateAndRMS().
+  struct XEstimateTable {
+    TAxis yAxis;
+    std::vector<double> xLowEdges; // nbinsX+1 edges
+    std::vector<bool> valid; // a window with enough entries exists
+    std::vector<int> lowBin, highBin;
+    std::vector<double> entries, rms;
+    std::vector<std::vector<double>> cdf; // normalized, nbinsX+1 values
+  };
+
+  // Means and spreads of a metric TProfile3D, flattened in loadMetrics()
+  // into contiguous arrays (X fastest) with the bin-width reciprocals
+  // precomputed. Only fixed-width binning is supported.
+  struct MetricGrid3D {
+    std::array<int, 3> nbins{{0, 0, 0}};
+    std::array<double, 3> low{{0., 0., 0.}};
+    std::array<double, 3> invWidth{{0., 0., 0.}};
+    std::vector<float> mean, spread;
+    // where a point falls in the grid: lower and upper bins (0-based)
+    // on each axis, and the weight of the upper one
+    struct Point {
+      std::array<int, 3> b0, b1;
+      std::array<double, 3> f;
+    };
+    size_t index(const int xb, const int yb, const int zb) const
+      {
+        return (size_t(zb)*nbins[1] + yb)*nbins[0] + xb;
+      }
+    // points outside the grid are moved to the outermost bins
+    Point locate(const double x, const double y, const double z,
+                 const bool interpolate) const
+      {
+        Point p;
+        const std::array<double, 3> v{{x, y, z}};
+        for(unsigned a=0; a<3; ++a){
+          double u = (v[a] - low[a])*invWidth[a];
+          if(interpolate){
+            u -= 0.5; // w.r.t. bin centers
+            if(!(u > 0.)) u = 0.;
+            else if(u > nbins[a]-1) u = nbins[a]-1;
+            p.b0[a] = int(u);
+            p.b1[a] = std::min(p.b0[a]+1, nbins[a]-1);
+            p.f[a] = u - p.b0[a];
+          }
+          else{
+            int b = (u > 0.) ? int(u) : 0;
+            if(b > nbins[a]-1) b = nbins[a]-1;
+            p.b0[a] = p.b1[a] = b;
+            p.f[a] = 0.;
+          }
+        }
+        return p;
+      }
+    // trilinear combination of the (up to) eight surrounding bins
+    std::tuple<double, double> at(const Point& p) const
+      {
+        double m = 0., s = 0.;
+        for(unsigned c=0; c<8; ++c){
+          const bool ux = c & 1, uy = c & 2, uz = c & 4;
+          const double w = (ux ? p.f[0] : 1.-p.f[0]) *
+            (uy ? p.f[1] : 1.-p.f[1]) * (uz ? p.f[2] : 1.-p.f[2]);
+          if(w == 0.) continue;
+          const size_t i = index(ux ? p.b1[0] : p.b0[0],
+                                 uy ? p.b1[1] : p.b0[1],
+                                 uz ? p.b1[2] : p.b0[2]);
+          m += w*mean[i];
+          s += w*spread[i];
+        }
+        return {m, s};
+      }
+  };
+
   // Variables loaded from the metrics file
   struct ReferenceMetrics {
     std::vector<double> dYMeans, dZMeans, RRMeans, RatioMeans,
@@ -93,10 +172,10 @@ public:
       std::unique_ptr<TF1> f;
     };
     TH2D* RRH2; TH2D* RatioH2;
+    XEstimateTable RRTable, RatioTable;
     std::array<Fits, 3> RRFits; // LEGACY
     std::array<Fits, 3> RatioFits; // LEGACY
-    TProfile3D* dYP3; TProfile3D* dZP3; TProfile3D* RRP3;
-    TProfile3D* RatioP3; TProfile3D* SlopeP3; TProfile3D* PEToQP3;
+    MetricGrid3D dYG3, dZG3, RRG3, RatioG3, SlopeG3, PEToQG3;
   };
 
   struct ChargeDigest {
@@ -148,6 +227,76 @@ public:
       {}
   };
 
+  // PE vs time histogram used by the simple flash finder. It follows the
+  // TH1D fixed-bin conventions (bin 0 underflow, nbins+1 overflow) the
+  // finder was written against, on a plain array the module reuses
+  // event after event instead of allocating ROOT histograms.
+  struct OpHitsTimeHist {
+    unsigned nbins = 0;
+    double xmin = 0., xmax = 0.;
+    std::vector<double> content;
+    unsigned entries = 0;
+    void Setup(const unsigned nbins_, const double xmin_, const double xmax_)
+      {
+        nbins = nbins_; xmin = xmin_; xmax = xmax_;
+        content.assign(nbins+2, 0.);
+        entries = 0;
+      }
+    void Reset()
+      {
+        std::fill(content.begin(), content.end(), 0.);
+        entries = 0;
+      }
+    int FindBin(const double x) const
+      {
+        if(x < xmin) return 0;
+        if(!(x < xmax)) return nbins+1;
+        return 1 + int(nbins*(x-xmin)/(xmax-xmin));
+      }
+    void Fill(const double x, const double w)
+      {
+        ++entries;
+        content[FindBin(x)] += w;
+      }
+    double GetBinCenter(const int bin) const
+      {
+        const double binwidth = (xmax-xmin)/double(nbins);
+        return xmin + (bin-1)*binwidth + 0.5*binwidth;
+      }
+    // sum of bins [first, last], under and overflow included if requested
+    double Integral(int first, int last) const
+      {
+        const int ncells = nbins+2;
+        if(first < 0) first = 0;
+        if(last >= ncells || last < first) last = ncells-1;
+        double sum = 0.;
+        for(int i=first; i<=last; ++i) sum += content[i];
+        return sum;
+      }
+    double Integral() const { return Integral(1, nbins); }
+    // first bin with the largest content in [first, last]
+    int GetMaximumBin(int first, int last) const
+      {
+        const int ncells = nbins+2;
+        if(last < first){ first = 1; last = nbins; }
+        if(first < 0) first = 0;
+        if(last >= ncells) last = ncells-1;
+        int locm = first;
+        double maximum = std::numeric_limits<double>::lowest();
+        for(int i=first; i<=last; ++i){
+          if(content[i] > maximum){ maximum = content[i]; locm = i; }
+        }
+        return locm;
+      }
+    int GetMaximumBin() const { return GetMaximumBin(1, nbins); }
+    // zero the bins [first, last)
+    void ClearBins(int first, const int last)
+      {
+        if(first < 0) first = 0;
+        for(int i=first; i<last && i<int(content.size()); ++i) content[i] = 0.;
+      }
+  };
+
   struct ChargeMetrics {
     unsigned id, activity;
     int pdgc;
@@ -284,8 +433,10 @@ private:
     double flash_rr, double flash_ratio) const;
   std::tuple<double, double, double, double> hypoFlashX_H2(
     double flash_rr, double flash_ratio) const;
+  XEstimateTable makeXEstimateTable(const TH2D* metric_h2) const;
+  MetricGrid3D makeMetricGrid3D(const TProfile3D* prof3) const;
   std::tuple<double, double> xEstimateAndRMS(
-    double metric_value, const TH2D* metric_h2) const;
+    double metric_value, const XEstimateTable& table) const;
   ChargeDigestMap makeChargeDigest(
     const art::Event& evt,
     const art::ValidHandle<std::vector<recob::PFParticle>>& pfps_h);
@@ -303,10 +454,10 @@ private:
                           const double mean, const double spread) const;
   inline double scoreTerm3D(
     const double m, const double n,
-    const int xb, const int yb, const int zb, const TProfile3D* prof3) const;
+    const MetricGrid3D::Point& p, const MetricGrid3D& grid) const;
   inline double scoreTerm3D(
     const double m,
-    const int xb, const int yb, const int zb, const TProfile3D* prof3) const;
+    const MetricGrid3D::Point& p, const MetricGrid3D& grid) const;
   inline double PEToQ(const double pe, const double q) const;
   inline bool pfpNeutrinoOnEvent(
     const art::ValidHandle<std::vector<recob::PFParticle>>& pfps_h) const;
@@ -323,17 +474,17 @@ private:
     const std::vector<recob::OpHit>& opHits,
     std::vector<recob::OpHit>& opHitsRght,
     std::vector<recob::OpHit>& opHitsLeft,
-    std::unique_ptr<TH1D>& opHitsTimeHist,
-    std::unique_ptr<TH1D>& opHitsTimeHistRght,
-    std::unique_ptr<TH1D>& opHitsTimeHistLeft) const;
+    OpHitsTimeHist& opHitsTimeHist,
+    OpHitsTimeHist& opHitsTimeHistRght,
+    OpHitsTimeHist& opHitsTimeHistLeft) const;
   unsigned createOpHitsTimeHist(//ICARUS overload
     const std::vector<recob::OpHit>& opHits,
-    std::unique_ptr<TH1D>& opHitsTimeHist) const;
+    OpHitsTimeHist& opHitsTimeHist) const;
   bool findSimpleFlashes(
     std::vector<SimpleFlash>& simpleFlashes,
     std::vector<recob::OpHit>& opHits,
     const unsigned ophsInVolume,
-    std::unique_ptr<TH1D>& opHitsTimeHist) const;
+    OpHitsTimeHist& opHitsTimeHist) const;
   inline std::string detectorName(const std::string detName) const;
   bool isPDInCryo(const int pdChannel) const;
   // bool isSBNDPDRelevant(const int pdChannel,
@@ -379,6 +530,7 @@ private:
   const bool fOnlyCollectionWires;
   const bool fForceConcurrence;
   const bool fUse3DMetrics;
+  const bool fInterpolate3DMetrics;
   const bool fCorrectDriftDistance;
   // const bool fUseCalo; TODO: Use calorimetry
   const bool fUseARAPUCAS;
@@ -411,6 +563,9 @@ private:
   const unsigned fOpDetNormalizer;
   const double fTermThreshold;
 
+  // reused by makeSimpleFlashes on every event
+  mutable OpHitsTimeHist fOpHitsTimeHist, fOpHitsTimeHistRght, fOpHitsTimeHistLeft;
+
   static constexpr unsigned kRght = 0;
   static constexpr unsigned kLeft = 1;
 
@@ -28,6 +28,7 @@ FlashPredict::FlashPredict(fhicl::ParameterSet const& p)
   , fOnlyCollectionWires(p.get<bool>("OnlyCollectionWires", true))
   , fForceConcurrence(p.get<bool>("ForceConcurrence", false)) // require light and charge to coincide, different requirements for SBND and ICARUS
   , fUse3DMetrics(p.get<bool>("Use3DMetrics", false)) // use metrics that depend on (X,Y,Z)
+  , fInterpolate3DMetrics(p.get<bool>("Interpolate3DMetrics", false)) // trilinear interpolation of the (X,Y,Z) metrics
   , fCorrectDriftDistance(p.get<bool>("CorrectDriftDistance", false)) // require light and charge to coincide, different requirements for SBND and ICARUS
   , fUseARAPUCAS(p.get<bool>("UseARAPUCAS", false))
   , fStoreMCInfo(p.get<bool>("StoreMCInfo", false))
@@ -94,6 +95,10 @@ FlashPredict::FlashPredict(fhicl::ParameterSet const& p)
       << "and fFlashEnd has to be non-negative.";
   }
 
+  fOpHitsTimeHist.Setup(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
+  fOpHitsTimeHistRght.Setup(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
+  fOpHitsTimeHistLeft.Setup(fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
+
   if(std::abs(p.get<double>("DriftDistance")-driftDistance()) > 0.001){
     mf::LogError("FlashPredict")
       << "Provided driftDistance: " << p.get<double>("DriftDistance")
@@ -634,6 +639,8 @@ FlashPredict::ReferenceMetrics FlashPredict::loadMetrics(
   rm.RRH2 = (TH2D*)tmp1_h2->Clone("RRH2");
   TH2* tmp2_h2 = (TH2*)infile->Get("ratio_h2");
   rm.RatioH2 = (TH2D*)tmp2_h2->Clone("RatioH2");
+  rm.RRTable = makeXEstimateTable(rm.RRH2);
+  rm.RatioTable = makeXEstimateTable(rm.RatioH2);
 
   std::vector<double>* polCoeffsY_p;
   infile->GetObject("pol_coeffs_y", polCoeffsY_p);
@@ -653,20 +660,12 @@ FlashPredict::ReferenceMetrics FlashPredict::loadMetrics(
 
   // BIG TODO: Metrics should depend on X,Y,Z.
   // TODO: Test!
-  // TODO: store 3D-arrays of means and spreads, instead of the
-  // TProfile3D
-  TProfile3D* tmp1_prof3 = (TProfile3D*)infile->Get("dy_prof3");
-  rm.dYP3 = (TProfile3D*)tmp1_prof3->Clone("dYP3");
-  TProfile3D* tmp2_prof3 = (TProfile3D*)infile->Get("dz_prof3");
-  rm.dZP3 = (TProfile3D*)tmp2_prof3->Clone("dZP3");
-  TProfile3D* tmp3_prof3 = (TProfile3D*)infile->Get("rr_prof3");
-  rm.RRP3 = (TProfile3D*)tmp3_prof3->Clone("RRP3");
-  TProfile3D* tmp4_prof3 = (TProfile3D*)infile->Get("ratio_prof3");
-  rm.RatioP3 = (TProfile3D*)tmp4_prof3->Clone("RatioP3");
-  TProfile3D* tmp5_prof3 = (TProfile3D*)infile->Get("slope_prof3");
-  rm.SlopeP3 = (TProfile3D*)tmp5_prof3->Clone("SlopeP3");
-  TProfile3D* tmp6_prof3 = (TProfile3D*)infile->Get("petoq_prof3");
-  rm.PEToQP3 = (TProfile3D*)tmp6_prof3->Clone("PEToQP3");
+  rm.dYG3 = makeMetricGrid3D((TProfile3D*)infile->Get("dy_prof3"));
+  rm.dZG3 = makeMetricGrid3D((TProfile3D*)infile->Get("dz_prof3"));
+  rm.RRG3 = makeMetricGrid3D((TProfile3D*)infile->Get("rr_prof3"));
+  rm.RatioG3 = makeMetricGrid3D((TProfile3D*)infile->Get("ratio_prof3"));
+  rm.SlopeG3 = makeMetricGrid3D((TProfile3D*)infile->Get("slope_prof3"));
+  rm.PEToQG3 = makeMetricGrid3D((TProfile3D*)infile->Get("petoq_prof3"));
 
   infile->Close();
   delete infile;
@@ -675,6 +674,38 @@ FlashPredict::ReferenceMetrics FlashPredict::loadMetrics(
 }
 
 
+FlashPredict::MetricGrid3D FlashPredict::makeMetricGrid3D(
+  const TProfile3D* prof3) const
+{
+  MetricGrid3D grid;
+  const std::array<const TAxis*, 3> axes{{
+      prof3->GetXaxis(), prof3->GetYaxis(), prof3->GetZaxis()}};
+  for(unsigned a=0; a<3; ++a){
+    if(axes[a]->IsVariableBinSize()){
+      throw cet::exception("FlashPredict")
+        << "The 3D metric '" << prof3->GetName()
+        << "' has variable bin sizes, which are not supported.";
+    }
+    grid.nbins[a] = axes[a]->GetNbins();
+    grid.low[a] = axes[a]->GetXmin();
+    grid.invWidth[a] = grid.nbins[a]/(axes[a]->GetXmax() - axes[a]->GetXmin());
+  }
+  const size_t ncells = size_t(grid.nbins[0])*grid.nbins[1]*grid.nbins[2];
+  grid.mean.resize(ncells);
+  grid.spread.resize(ncells);
+  for(int zb=0; zb<grid.nbins[2]; ++zb){
+    for(int yb=0; yb<grid.nbins[1]; ++yb){
+      for(int xb=0; xb<grid.nbins[0]; ++xb){
+        const size_t i = grid.index(xb, yb, zb);
+        grid.mean[i] = prof3->GetBinContent(xb+1, yb+1, zb+1);
+        grid.spread[i] = prof3->GetBinError(xb+1, yb+1, zb+1);
+      }
+    }
+  }
+  return grid;
+}
+
+
 std::tuple<double, bool> FlashPredict::cheatMCT0_IsNu(
   const std::vector<art::Ptr<recob::Hit>>& hits,
   const std::vector<art::Ptr<simb::MCParticle>>& mcParticles) const
@@ -1018,32 +1049,26 @@ FlashPredict::Score FlashPredict::computeScore3D(
   double charge_x = (fCorrectDriftDistance) ?
     driftCorrection(charge.x, flash.time) : charge.x;
 
-  int xb = fRM.dYP3->GetXaxis()->FindBin(charge_x);
-  if (xb < 1) xb = 1;
-  else if (xb > fRM.dYP3->GetXaxis()->GetNbins()) xb = fRM.dYP3->GetXaxis()->GetNbins();
-  int yb = fRM.dYP3->GetYaxis()->FindBin(charge.y);
-  if (yb < 1) yb = 1;
-  else if (yb > fRM.dYP3->GetYaxis()->GetNbins()) yb = fRM.dYP3->GetYaxis()->GetNbins();
-  int zb = fRM.dYP3->GetZaxis()->FindBin(charge.z);
-  if (zb < 1) zb = 1;
-  else if (zb > fRM.dYP3->GetZaxis()->GetNbins()) zb = fRM.dYP3->GetZaxis()->GetNbins();
- 
-  score.y = scoreTerm3D(flash.y, charge.y, xb, yb, zb, fRM.dYP3);
+  // all the 3D metrics share the same binning
+  const auto pt = fRM.dYG3.locate(charge_x, charge.y, charge.z,
+                                  fInterpolate3DMetrics);
+
+  score.y = scoreTerm3D(flash.y, charge.y, pt, fRM.dYG3);
   if(score.y > fTermThreshold) printMetrics("Y", charge, flash, score.y,
                                             mf::LogDebug("FlashPredict"));
   score.total += score.y;
   tcount++;
-  score.z = scoreTerm3D(flash.z, charge.z, xb, yb, zb, fRM.dZP3);
+  score.z = scoreTerm3D(flash.z, charge.z, pt, fRM.dZG3);
   if(score.z > fTermThreshold) printMetrics("Z", charge, flash, score.z,
                                             mf::LogDebug("FlashPredict"));
   score.total += score.z;
   tcount++;
-  score.rr = scoreTerm3D(flash.rr, xb, yb, zb, fRM.RRP3);
+  score.rr = scoreTerm3D(flash.rr, pt, fRM.RRG3);
   if(score.rr > fTermThreshold) printMetrics("RR", charge, flash, score.rr,
                                              mf::LogDebug("FlashPredict"));
   score.total += score.rr;
   tcount++;
-  score.ratio = scoreTerm3D(flash.ratio, xb, yb, zb, fRM.RatioP3);
+  score.ratio = scoreTerm3D(flash.ratio, pt, fRM.RatioG3);
   if(fICARUS && !std::isnan(flash.h_x)){
     // TODO HACK to penalise matches with flash and charge on opposite volumes
     double charge_x_gl = (fCorrectDriftDistance) ?
@@ -1053,7 +1078,7 @@ FlashPredict::Score FlashPredict::computeScore3D(
     double cathode_tolerance = 30.;
     if(x_gl_diff > x_diff + cathode_tolerance) { // ok if close to the cathode
       double penalization = scoreTerm3D((flash.pe-flash.unpe)/flash.pe,
-                                        xb, yb, zb, fRM.RatioP3);
+                                        pt, fRM.RatioG3);
       score.ratio += penalization;
       mf::LogInfo("FlashPredict")
         << "HACK: Penalizing match with flash and charge in opposite volumes."
@@ -1068,8 +1093,8 @@ FlashPredict::Score FlashPredict::computeScore3D(
   score.total += score.ratio;
   tcount++;
 
-  // score.slope = scoreTerm3D(flash.slope, charge.slope, xb, yb, zb, fRM.SlopeP3);
-  score.slope = scoreTerm3D(flash.xw, xb, yb, zb, fRM.SlopeP3);
+  // score.slope = scoreTerm3D(flash.slope, charge.slope, pt, fRM.SlopeG3);
+  score.slope = scoreTerm3D(flash.xw, pt, fRM.SlopeG3);
   if(score.slope > fTermThreshold) printMetrics("SLOPE", charge, flash, score.slope,
                                                 mf::LogDebug("FlashPredict"));
   // TODO: if useful add it to the total score
@@ -1077,7 +1102,7 @@ FlashPredict::Score FlashPredict::computeScore3D(
   // tcount++;
   // TODO: if useful add it to the total score
   score.petoq = scoreTerm3D(std::log(flash.pe)/std::log(charge.q),
-                            xb, yb, zb, fRM.PEToQP3);
+                            pt, fRM.PEToQG3);
   if(score.petoq > fTermThreshold) printMetrics("LIGHT/CHARGE", charge, flash, score.petoq,
                                                 mf::LogDebug("FlashPredict"));
     score.total += score.petoq;
@@ -1181,8 +1206,8 @@ std::tuple<double, double, double, double> FlashPredict::hypoFlashX_fits(
 std::tuple<double, double, double, double> FlashPredict::hypoFlashX_H2(
   double flash_rr, double flash_ratio) const
 {
-  auto[rr_hypoX, rr_hypoXRMS] = xEstimateAndRMS(flash_rr, fRM.RRH2);
-  auto[ratio_hypoX, ratio_hypoXRMS] = xEstimateAndRMS(flash_ratio, fRM.RatioH2);
+  auto[rr_hypoX, rr_hypoXRMS] = xEstimateAndRMS(flash_rr, fRM.RRTable);
+  auto[ratio_hypoX, ratio_hypoXRMS] = xEstimateAndRMS(flash_ratio, fRM.RatioTable);
 
   double drr2 = rr_hypoXRMS*rr_hypoXRMS;
   double dratio2 = ratio_hypoXRMS*ratio_hypoXRMS;
@@ -1201,39 +1226,110 @@ std::tuple<double, double, double, double> FlashPredict::hypoFlashX_H2(
 }
 
 
-std::tuple<double, double> FlashPredict::xEstimateAndRMS(
-  double metric_value, const TH2D* metric_h2) const
+FlashPredict::XEstimateTable FlashPredict::makeXEstimateTable(
+  const TH2D* metric_h2) const
 {
-  int bin = metric_h2->GetYaxis()->FindBin(metric_value);
-  int bins = metric_h2->GetNbinsY();
-  int bin_buff = 0;
-  // TODO: figure out a better method to make the estimates near the edges
-  // For instance with this answer to estimate truncated means and std dev
-  // https://stats.stackexchange.com/a/136929
-  while(0 < bin-bin_buff || bin+bin_buff <= bins){
-    int low_bin = (0 < bin-bin_buff) ? bin-bin_buff : 0;
-    int high_bin = (bin+bin_buff <= bins) ? bin+bin_buff : -1;
-    auto metric_px = std::make_unique<TH1D>(
-      *(metric_h2->ProjectionX("metric_px", low_bin, high_bin)));
-    if(metric_px->GetEntries() > kMinEntriesInProjection){
-      double metric_hypoX = metric_px->GetRandom();
-      // metric_hypoX = metric_px->GetMean(); // TODO: which one is more justified?
-      double metric_rmsX = metric_px->GetRMS();
-      if(metric_rmsX < fXBinWidth/2.){//something went wrong // TODO: better test to see if things are OK
-        mf::LogDebug("FlashPredict")
-          << "metric_h2 projected on metric_value: "<< metric_value
-          << ", bin: " << bin
-          << ", bin_buff: " << bin_buff
-          << "; has " << metric_px->GetEntries() << " entries."
-          << "\nmetric_hypoX: " << metric_hypoX
-          << ",  metric_rmsX: " << metric_rmsX;
-        return {-10., fDriftDistance}; // no estimate
+  // Reproduces, for every Y bin, what ProjectionX() over the widening
+  // window would give: the entries, the RMS and the cumulative
+  // distribution GetRandom() samples from
+  XEstimateTable table;
+  table.yAxis = *(metric_h2->GetYaxis());
+  const int xbins = metric_h2->GetNbinsX();
+  const int bins = metric_h2->GetNbinsY();
+  const TAxis* xAxis = metric_h2->GetXaxis();
+  for(int xb=1; xb<=xbins+1; ++xb)
+    table.xLowEdges.push_back(xAxis->GetBinLowEdge(xb));
+  const size_t ncells = bins+2;
+  table.valid.assign(ncells, false);
+  table.lowBin.assign(ncells, 0);
+  table.highBin.assign(ncells, 0);
+  table.entries.assign(ncells, 0.);
+  table.rms.assign(ncells, 0.);
+  table.cdf.assign(ncells, std::vector<double>());
+
+  std::vector<double> projection(xbins+2);
+  for(int bin=0; bin<=bins+1; ++bin){
+    int bin_buff = 0;
+    // TODO: figure out a better method to make the estimates near the edges
+    // For instance with this answer to estimate truncated means and std dev
+    // https://stats.stackexchange.com/a/136929
+    while(0 < bin-bin_buff || bin+bin_buff <= bins){
+      int low_bin = (0 < bin-bin_buff) ? bin-bin_buff : 0;
+      int high_bin = (bin+bin_buff <= bins) ? bin+bin_buff : bins+1;
+      double totcont = 0., sumw2 = 0.;
+      for(int xb=0; xb<=xbins+1; ++xb){
+        double cont = 0.;
+        for(int yb=low_bin; yb<=high_bin; ++yb){
+          cont += metric_h2->GetBinContent(xb, yb);
+          double err = metric_h2->GetBinError(xb, yb);
+          sumw2 += err*err;
+        }
+        projection[xb] = cont;
+        totcont += cont;
       }
-      return {metric_hypoX, metric_rmsX};
+      double entries = std::floor(totcont + 0.5);
+      if(low_bin == 0 && high_bin == bins+1)
+        entries = metric_h2->GetEntries();
+      else if(metric_h2->GetSumw2N() && sumw2 > 0.)
+        entries = totcont*totcont/sumw2;
+      if(entries > kMinEntriesInProjection){
+        double sumw = 0., sumwx = 0., sumwx2 = 0.;
+        std::vector<double> cdf(xbins+1, 0.);
+        for(int xb=1; xb<=xbins; ++xb){
+          double w = projection[xb];
+          double x = xAxis->GetBinCenter(xb);
+          sumw += w; sumwx += w*x; sumwx2 += w*x*x;
+          cdf[xb] = cdf[xb-1] + w;
+        }
+        if(cdf[xbins] != 0.)
+          for(auto& c : cdf) c /= cdf[xbins];
+        double mean = (sumw != 0.) ? sumwx/sumw : 0.;
+        table.rms[bin] = (sumw != 0.) ?
+          std::sqrt(std::abs(sumwx2/sumw - mean*mean)) : 0.;
+        table.valid[bin] = true;
+        table.lowBin[bin] = low_bin;
+        table.highBin[bin] = high_bin;
+        table.entries[bin] = entries;
+        table.cdf[bin] = std::move(cdf);
+        break;
+      }
+      bin_buff += 1;
     }
-    bin_buff += 1;
   }
-  return {-10., fDriftDistance}; // no estimate
+  return table;
+}
+
+
+std::tuple<double, double> FlashPredict::xEstimateAndRMS(
+  double metric_value, const XEstimateTable& table) const
+{
+  int bin = table.yAxis.FindFixBin(metric_value);
+  if(!table.valid[bin]) return {-10., fDriftDistance}; // no estimate
+  // sample the projection the same way TH1::GetRandom() does
+  const auto& cdf = table.cdf[bin];
+  double metric_hypoX = 0.;
+  if(cdf.back() != 0.){
+    double r1 = gRandom->Rndm();
+    int ibin = std::distance(cdf.begin(),
+                             std::upper_bound(cdf.begin(), cdf.end()-1, r1)) - 1;
+    metric_hypoX = table.xLowEdges[ibin];
+    if(r1 > cdf[ibin])
+      metric_hypoX += (table.xLowEdges[ibin+1] - table.xLowEdges[ibin]) *
+        (r1 - cdf[ibin]) / (cdf[ibin+1] - cdf[ibin]);
+  }
+  // metric_hypoX = mean of the projection; // TODO: which one is more justified?
+  double metric_rmsX = table.rms[bin];
+  if(metric_rmsX < fXBinWidth/2.){//something went wrong // TODO: better test to see if things are OK
+    mf::LogDebug("FlashPredict")
+      << "metric_h2 projected on metric_value: "<< metric_value
+      << ", bin: " << bin
+      << ", bins: [" << table.lowBin[bin] << ", " << table.highBin[bin] << "]"
+      << "; has " << table.entries[bin] << " entries."
+      << "\nmetric_hypoX: " << metric_hypoX
+      << ",  metric_rmsX: " << metric_rmsX;
+    return {-10., fDriftDistance}; // no estimate
+  }
+  return {metric_hypoX, metric_rmsX};
 }
 
 
@@ -1241,21 +1337,7 @@ FlashPredict::ChargeDigestMap FlashPredict::makeChargeDigest(
   const art::Event& evt,
   const art::ValidHandle<std::vector<recob::PFParticle>>& pfps_h)
 {
-  // grab spacepoints associated with PFParticles
-  const art::FindManyP<recob::SpacePoint>
-    pfp_spacepoints_assns(pfps_h, evt, fPandoraProducer);
-  const auto& spacepoints_h =
-    evt.getValidHandle<std::vector<recob::SpacePoint>>(fSpacePointProducer);
-  const art::FindManyP<recob::Hit>
-    spacepoint_hits_assns(spacepoints_h, evt, fSpacePointProducer);
-  // grab tracks associated with PFParticles
-  // auto const& track_h = evt.getValidHandle<std::vector<recob::Track> >(fTrackProducer);
-  // art::FindManyP<recob::Track> pfp_track_assn_v(track_h, evt, fTrackProducer);
-  // grab calorimetry info for tracks
-  // auto const& calo_h =
-  //   evt.getValidHandle<std::vector<anab::Calorimetry> >(fCaloProducer);
-  // art::FindManyP<anab::Calorimetry>  track_calo_assn_v(calo_h,
-  //                                                      evt, fCaloProducer);
+  const auto digest_start = std::chrono::steady_clock::now();
 
   std::vector<art::Ptr<simb::MCParticle>> mcParticles;
   if(fStoreMCInfo){
@@ -1269,38 +1351,18 @@ FlashPredict::ChargeDigestMap FlashPredict::makeChargeDigest(
     pfpMap[pfps_h->at(pId).Self()] = pId;
   }
 
-  // TODO: this block is meant to only load the charge related objects
-  // of the slices that are potentially neutrinos, this to improve
-  // performance. Loading these objects is currently what that takes
-  // the most time. Unfortunately, the objects are not very robust and
-  // frequently there's out of bounds requests.
-  //
-  // std::vector<art::Ptr<recob::PFParticle>> particles_in_slices;
-  // for(size_t pId=0; pId<pfps_h->size(); pId++) {
-  //   if(!pfps_h->at(pId).IsPrimary()) continue;
-  //   const art::Ptr<recob::PFParticle> pfp_ptr(pfps_h, pId);
-  //   unsigned pfpPDGC = std::abs(pfp_ptr->PdgCode());
-  //   if(fSelectNeutrino &&
-  //      (pfpPDGC != 12) && (pfpPDGC != 14) && (pfpPDGC != 16)) continue;
-  //   std::vector<art::Ptr<recob::PFParticle>> particles;
-  //   addDaughters(pfpMap, pfp_ptr, pfps_h, particles);
-  //   particles_in_slices.insert(particles_in_slices.end(),
-  //                              particles.begin(), particles.end());
-  // }
-  // const art::FindManyP<recob::SpacePoint>
-  //   pfp_spacepoints_assns(particles_in_slices, evt, fPandoraProducer);
-  // std::vector<art::Ptr<recob::SpacePoint>> spacepoints_in_slices;
-  // // for(auto& p: particles_in_slices) {
-  // for(size_t p=0; p<particles_in_slices.size(); ++p) {
-  //   auto& sps = pfp_spacepoints_assns.at(p);
-  //   spacepoints_in_slices.insert(spacepoints_in_slices.end(), sps.begin(), sps.end());
-  // }
-  // const art::FindManyP<recob::Hit>
-  //   spacepoint_hits_assns(spacepoints_in_slices, evt, fSpacePointProducer);
-  // TODO: this block is meant to only load the charge related objects
-
   ChargeDigestMap chargeDigestMap;
-  // Loop over pandora pfp particles
+
+  // First pass: walk the PFParticle hierarchy and pick the candidate
+  // slices, only these need their charge related objects loaded
+  struct SliceCandidate {
+    size_t pId;
+    unsigned pfpPDGC;
+    art::Ptr<recob::PFParticle> pfp_ptr;
+    std::vector<art::Ptr<recob::PFParticle>> particles;
+  };
+  std::vector<SliceCandidate> candidates;
+  std::vector<bool> pfpInCandidate(pfps_h->size(), false);
   for(size_t pId=0; pId<pfps_h->size(); pId++) {
     if(!pfps_h->at(pId).IsPrimary()) continue;
     const art::Ptr<recob::PFParticle> pfp_ptr(pfps_h, pId);
@@ -1313,20 +1375,65 @@ FlashPredict::ChargeDigestMap FlashPredict::makeChargeDigest(
     }
     std::vector<art::Ptr<recob::PFParticle>> particles_in_slice;
     addDaughters(pfpMap, pfp_ptr, pfps_h, particles_in_slice);
+    for(const auto& particle: particles_in_slice)
+      pfpInCandidate[particle.key()] = true;
+    candidates.push_back({pId, pfpPDGC, pfp_ptr, std::move(particles_in_slice)});
+  }
+
+  // Second pass: resolve the PFParticle->SpacePoint->Hit associations
+  // by Ptr key, and only for the particles of the candidate slices.
+  // The association products are walked once, keeping the association
+  // order, instead of building full FindManyP tables over every
+  // PFParticle and every SpacePoint in the event.
+  std::unordered_map<size_t, std::vector<art::Ptr<recob::SpacePoint>>> pfpSpacepoints;
+  std::unordered_map<size_t, std::vector<art::Ptr<recob::Hit>>> spacepointHits;
+  size_t nAssnsSpacepoints = 0;
+  if(!candidates.empty()){
+    const auto& pfp_spacepoints_assns =
+      evt.getValidHandle<art::Assns<recob::PFParticle, recob::SpacePoint>>(fPandoraProducer);
+    for(const auto& [pfp, spacepoint] : *pfp_spacepoints_assns) {
+      if(pfp.id() != pfps_h.id() || pfp.key() >= pfpInCandidate.size() ||
+         !pfpInCandidate[pfp.key()]) continue;
+      pfpSpacepoints[pfp.key()].push_back(spacepoint);
+      spacepointHits.emplace(spacepoint.key(), std::vector<art::Ptr<recob::Hit>>{});
+    }
+    const auto& spacepoints_h =
+      evt.getValidHandle<std::vector<recob::SpacePoint>>(fSpacePointProducer);
+    const auto& spacepoint_hits_assns =
+      evt.getValidHandle<art::Assns<recob::SpacePoint, recob::Hit>>(fSpacePointProducer);
+    nAssnsSpacepoints = spacepoints_h->size();
+    for(const auto& [spacepoint, hit] : *spacepoint_hits_assns) {
+      if(spacepoint.id() != spacepoints_h.id()) continue;
+      auto sp_hits = spacepointHits.find(spacepoint.key());
+      if(sp_hits == spacepointHits.end()) continue;
+      sp_hits->second.push_back(hit);
+    }
+  }
+  const std::vector<art::Ptr<recob::SpacePoint>> noSpacepoints;
+  const std::vector<art::Ptr<recob::Hit>> noHits;
+
+  // Loop over candidate slices
+  for(const auto& candidate: candidates) {
+    const size_t pId = candidate.pId;
+    const unsigned pfpPDGC = candidate.pfpPDGC;
+    const auto& pfp_ptr = candidate.pfp_ptr;
+    const auto& particles_in_slice = candidate.particles;
 
     double sliceQ = 0.;
     std::vector<art::Ptr<recob::Hit>> hits_in_slice;
     flashmatch::QCluster_t particlesClusters;
     std::set<unsigned> particlesTPCs;
     for(const auto& particle: particles_in_slice) {
-      const auto particle_key = particle.key();
-      const auto& particle_spacepoints = pfp_spacepoints_assns.at(particle_key);
+      const auto particle_sps = pfpSpacepoints.find(particle.key());
+      const auto& particle_spacepoints = (particle_sps != pfpSpacepoints.end()) ?
+        particle_sps->second : noSpacepoints;
       double particleQ = 0.;
       flashmatch::QCluster_t spsClusters;
       std::set<unsigned> spsTPCs;
       for(const auto& spacepoint : particle_spacepoints) {
-        const auto spacepoint_key = spacepoint.key();
-        const auto& hits = spacepoint_hits_assns.at(spacepoint_key);
+        const auto sp_hits = spacepointHits.find(spacepoint.key());
+        const auto& hits = (sp_hits != spacepointHits.end()) ?
+          sp_hits->second : noHits;
         if(fStoreMCInfo){
           hits_in_slice.insert(hits_in_slice.end(),
                                hits.begin(), hits.end());
@@ -1386,6 +1493,14 @@ FlashPredict::ChargeDigestMap FlashPredict::makeChargeDigest(
       ChargeDigest(pId, pfpPDGC, pfp_ptr, particlesClusters, hitsInVolume,
                    mcT0, isNu);
   } // over all slices
+
+  const auto digest_time = std::chrono::duration_cast<std::chrono::microseconds>
+    (std::chrono::steady_clock::now() - digest_start);
+  mf::LogDebug("FlashPredict")
+    << "makeChargeDigest: " << candidates.size() << " candidate slices out of "
+    << pfps_h->size() << " PFParticles, hits resolved for "
+    << spacepointHits.size() << "/" << nAssnsSpacepoints << " spacepoints, in "
+    << digest_time.count() << " us";
   return chargeDigestMap;
 }
 
@@ -1475,13 +1590,9 @@ double FlashPredict::scoreTerm(const double m,
 inline
 double FlashPredict::scoreTerm3D(
   const double m, const double n,
-  const int xb, const int yb, const int zb, const TProfile3D* prof3) const
+  const MetricGrid3D::Point& p, const MetricGrid3D& grid) const
 {
-  // TODO: these means and spreads should be stored in 3D-arrays
-  // during loadMetrics(), instead of computing them every time. When
-  // that's done, these functions (scoreTerm3D()) should be removed.
-  double mean = prof3->GetBinContent(xb, yb, zb);
-  double spread = prof3->GetBinError(xb, yb, zb);
+  auto [mean, spread] = grid.at(p);
   return scoreTerm(m, n, mean, spread);
 }
 
@@ -1489,9 +1600,9 @@ double FlashPredict::scoreTerm3D(
 inline
 double FlashPredict::scoreTerm3D(
   const double m,
-  const int xb, const int yb, const int zb, const TProfile3D* prof3) const
+  const MetricGrid3D::Point& p, const MetricGrid3D& grid) const
 {
-  return scoreTerm3D(m, 0., xb, yb, zb, prof3);
+  return scoreTerm3D(m, 0., p, grid);
 }
 
 
@@ -1544,30 +1655,24 @@ std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
   std::vector<recob::OpHit>& opHitsRght,
   std::vector<recob::OpHit>& opHitsLeft) const
 {
-  std::unique_ptr<TH1D> opHitsTimeHist = std::make_unique<TH1D>(
-    "opHitsTimeHist", "ophittime", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHist->SetOption("HIST");
-  opHitsTimeHist->SetDirectory(0);//turn off ROOT's object ownership
-  std::unique_ptr<TH1D> opHitsTimeHistRght = std::make_unique<TH1D>(
-    "opHitsTimeHistRght", "ophittimer", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHistRght->SetOption("HIST");
-  opHitsTimeHistRght->SetDirectory(0);//turn off ROOT's object ownership
-  std::unique_ptr<TH1D> opHitsTimeHistLeft = std::make_unique<TH1D>(
-    "opHitsTimeHistLeft", "ophittimel", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHistLeft->SetOption("HIST");
-  opHitsTimeHistLeft->SetDirectory(0);//turn off ROOT's object ownership
+  OpHitsTimeHist& opHitsTimeHist = fOpHitsTimeHist;
+  OpHitsTimeHist& opHitsTimeHistRght = fOpHitsTimeHistRght;
+  OpHitsTimeHist& opHitsTimeHistLeft = fOpHitsTimeHistLeft;
+  opHitsTimeHist.Reset();
+  opHitsTimeHistRght.Reset();
+  opHitsTimeHistLeft.Reset();
   if(!createOpHitsTimeHist(
        opHits, opHitsRght, opHitsLeft,
        opHitsTimeHist, opHitsTimeHistRght, opHitsTimeHistLeft)) return {};
 
   bool oph_in_rght = false, oph_in_left = false;
   std::vector<FlashPredict::SimpleFlash> simpleFlashes;
-  if(opHitsRght.size() > 0 && opHitsTimeHistRght->GetEntries() > 0){
+  if(opHitsRght.size() > 0 && opHitsTimeHistRght.entries > 0){
     oph_in_rght = true;
     findSimpleFlashes(simpleFlashes, opHitsRght,
                       kActivityInRght, opHitsTimeHistRght);
   }
-  if(opHitsLeft.size() > 0 && opHitsTimeHistLeft->GetEntries() > 0){
+  if(opHitsLeft.size() > 0 && opHitsTimeHistLeft.entries > 0){
     oph_in_left = true;
     findSimpleFlashes(simpleFlashes, opHitsLeft,
                       kActivityInLeft, opHitsTimeHistLeft);
@@ -1586,10 +1691,8 @@ std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
 std::vector<FlashPredict::SimpleFlash> FlashPredict::makeSimpleFlashes(
   std::vector<recob::OpHit>& opHits) const
 {
-  std::unique_ptr<TH1D> opHitsTimeHist = std::make_unique<TH1D>(
-    "opHitsTimeHist", "ophittime", fTimeBins, fFlashFindingTimeStart, fFlashFindingTimeEnd);
-  opHitsTimeHist->SetOption("HIST");
-  opHitsTimeHist->SetDirectory(0);//turn off ROOT's object ownership
+  OpHitsTimeHist& opHitsTimeHist = fOpHitsTimeHist;
+  opHitsTimeHist.Reset();
   unsigned ophsInVolume = createOpHitsTimeHist(opHits, opHitsTimeHist);
   if(ophsInVolume == 0) return {};
 
@@ -1605,33 +1708,33 @@ bool FlashPredict::createOpHitsTimeHist(
   const std::vector<recob::OpHit>& opHits,
   std::vector<recob::OpHit>& opHitsRght,
   std::vector<recob::OpHit>& opHitsLeft,
-  std::unique_ptr<TH1D>& opHitsTimeHist,
-  std::unique_ptr<TH1D>& opHitsTimeHistRght,
-  std::unique_ptr<TH1D>& opHitsTimeHistLeft) const
+  OpHitsTimeHist& opHitsTimeHist,
+  OpHitsTimeHist& opHitsTimeHistRght,
+  OpHitsTimeHist& opHitsTimeHistLeft) const
 {
   for(const auto& oph : opHits) {
     auto ch = oph.OpChannel();
-    opHitsTimeHist->Fill(opHitTime(oph), oph.PE());
+    opHitsTimeHist.Fill(opHitTime(oph), oph.PE());
     if(sbndPDinTPC(ch) == kRght){
       opHitsRght.emplace_back(oph);
-      opHitsTimeHistRght->Fill(opHitTime(oph), oph.PE());
+      opHitsTimeHistRght.Fill(opHitTime(oph), oph.PE());
     }
     else{// sbndPDinTPC(ch) == kLeft
       opHitsLeft.emplace_back(oph);
-      opHitsTimeHistLeft->Fill(opHitTime(oph), oph.PE());
+      opHitsTimeHistLeft.Fill(opHitTime(oph), oph.PE());
     }
   }
-  if(opHitsTimeHist->GetEntries() <= 0 ||
-     opHitsTimeHist->Integral() <= 0. ||
-     opHitsTimeHist->Integral() <= fMinFlashPE) return false;
-  if(opHitsTimeHistRght->GetEntries() <= 0 ||
-     opHitsTimeHistRght->Integral() <= 0. ||
-     opHitsTimeHistRght->Integral() <= fMinFlashPE)
-    opHitsTimeHistRght->Reset();
-  if(opHitsTimeHistLeft->GetEntries() <= 0 ||
-     opHitsTimeHistLeft->Integral() <= 0. ||
-     opHitsTimeHistLeft->Integral() <= fMinFlashPE)
-    opHitsTimeHistLeft->Reset();
+  if(opHitsTimeHist.entries == 0 ||
+     opHitsTimeHist.Integral() <= 0. ||
+     opHitsTimeHist.Integral() <= fMinFlashPE) return false;
+  if(opHitsTimeHistRght.entries == 0 ||
+     opHitsTimeHistRght.Integral() <= 0. ||
+     opHitsTimeHistRght.Integral() <= fMinFlashPE)
+    opHitsTimeHistRght.Reset();
+  if(opHitsTimeHistLeft.entries == 0 ||
+     opHitsTimeHistLeft.Integral() <= 0. ||
+     opHitsTimeHistLeft.Integral() <= fMinFlashPE)
+    opHitsTimeHistLeft.Reset();
   return true;
 }
 
@@ -1639,21 +1742,21 @@ bool FlashPredict::createOpHitsTimeHist(
 //ICARUS overload
 unsigned FlashPredict::createOpHitsTimeHist(
   const std::vector<recob::OpHit>& opHits,
-  std::unique_ptr<TH1D>& opHitsTimeHist) const
+  OpHitsTimeHist& opHitsTimeHist) const
 {
   bool in_right = false, in_left = false;
   for(auto const& oph : opHits) {
     auto ch = oph.OpChannel();
     auto opDetXYZ = fGeometry->OpDetGeoFromOpChannel(ch).GetCenter();
     if(!fGeoCryo->ContainsPosition(opDetXYZ)) continue;
-    opHitsTimeHist->Fill(opHitTime(oph), oph.PE());
+    opHitsTimeHist.Fill(opHitTime(oph), oph.PE());
     unsigned t = icarusPDinTPC(ch);
     if(t/fTPCPerDriftVolume == kRght) in_right = true;
     else if(t/fTPCPerDriftVolume == kLeft) in_left = true;
   }
-  if(opHitsTimeHist->GetEntries() <= 0 ||
-     opHitsTimeHist->Integral() <= 0. ||
-     opHitsTimeHist->Integral() <= fMinFlashPE) return 0;
+  if(opHitsTimeHist.entries == 0 ||
+     opHitsTimeHist.Integral() <= 0. ||
+     opHitsTimeHist.Integral() <= fMinFlashPE) return 0;
   if(in_right && in_left) return kActivityInBoth;
   else if(in_right && !in_left) return kActivityInRght;
   else if(!in_right && in_left) return kActivityInLeft;
@@ -1665,28 +1768,26 @@ bool FlashPredict::findSimpleFlashes(
   std::vector<FlashPredict::SimpleFlash>& simpleFlashes,
   std::vector<recob::OpHit>& opHits,
   const unsigned ophsInVolume,
-  std::unique_ptr<TH1D>& opHitsTimeHist) const
+  OpHitsTimeHist& opHitsTimeHist) const
 {
   OpHitIt opH_beg = opHits.begin();
   for(unsigned flashId=0; flashId<fMaxFlashes; ++flashId){
     double maxpeak_time = std::numeric_limits<double>::min();
     if (flashId < fMinInTimeFlashes) { // First flashes have to be within the beam spill
-      int beam_start_bin = opHitsTimeHist->FindBin(fBeamSpillTimeStart);
-      int beam_end_bin = opHitsTimeHist->FindBin(fBeamSpillTimeEnd);
-      opHitsTimeHist->GetXaxis()->SetRange(beam_start_bin, beam_end_bin);
-      int ibin_beam = opHitsTimeHist->GetMaximumBin();
-      maxpeak_time = opHitsTimeHist->GetBinCenter(ibin_beam);
-      opHitsTimeHist->GetXaxis()->SetRange(0, 0); // reset range
+      int beam_start_bin = opHitsTimeHist.FindBin(fBeamSpillTimeStart);
+      int beam_end_bin = opHitsTimeHist.FindBin(fBeamSpillTimeEnd);
+      int ibin_beam = opHitsTimeHist.GetMaximumBin(beam_start_bin, beam_end_bin);
+      maxpeak_time = opHitsTimeHist.GetBinCenter(ibin_beam);
     }
     else {
-      int ibin = opHitsTimeHist->GetMaximumBin();
-      maxpeak_time = opHitsTimeHist->GetBinCenter(ibin);
+      int ibin = opHitsTimeHist.GetMaximumBin();
+      maxpeak_time = opHitsTimeHist.GetBinCenter(ibin);
     }
     double lowedge  = maxpeak_time + fFlashStart;
     double highedge = maxpeak_time + fFlashEnd;
-    int lowedge_bin = opHitsTimeHist->FindBin(lowedge);
-    int highedge_bin = opHitsTimeHist->FindBin(highedge);
-    double ophits_integral = opHitsTimeHist->Integral(lowedge_bin, highedge_bin);
+    int lowedge_bin = opHitsTimeHist.FindBin(lowedge);
+    int highedge_bin = opHitsTimeHist.FindBin(highedge);
+    double ophits_integral = opHitsTimeHist.Integral(lowedge_bin, highedge_bin);
     mf::LogDebug("FlashPredict")
       << "Finding Simple Flashes, "
       << "flashId: " << flashId << ",    "
@@ -1696,9 +1797,7 @@ bool FlashPredict::findSimpleFlashes(
       << "light window [" << lowedge << ", " << highedge << "] us, "
       << "[ " << lowedge_bin << ", " << highedge_bin << "] bins";
     // clear this peak to enforce non-overlapping flashes
-    for(int i=lowedge_bin; i<highedge_bin; ++i){
-      opHitsTimeHist->SetBinContent(i, 0.);
-    }
+    opHitsTimeHist.ClearBins(lowedge_bin, highedge_bin);
     // check if flash has enough PEs, skip if is the first two flashes
     if (ophits_integral <= fMinFlashPE || ophits_integral <= 0.){
       if(flashId == 0 || flashId == 1) continue;
@@ -0,0 +1,131 @@
+#ifndef BOXBVH_H_SEEN
+#define BOXBVH_H_SEEN
+
+
+///////////////////////////////////////////////
+// BoxBVH.h
+//
+// Bounding volume hierarchy over axis aligned
+// boxes, used to find the boxes containing a
+// point without looping over all of them
+///////////////////////////////////////////////
+
+// c++
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sbn{
+
+  class BoxBVH {
+  public:
+
+    struct Box{
+      double min[3];
+      double max[3];
+    };
+
+    BoxBVH() = default;
+
+    // Build the hierarchy, box indices are the positions in the input vector
+    explicit BoxBVH(const std::vector<Box>& boxes):
+      fBoxes(boxes)
+    {
+      fOrder.resize(fBoxes.size());
+      for(size_t i = 0; i < fOrder.size(); i++) fOrder[i] = i;
+      if(!fBoxes.empty()) Build(0, fOrder.size());
+    }
+
+    size_t NumBoxes() const { return fBoxes.size(); }
+
+    const Box& GetBox(size_t i) const { return fBoxes[i]; }
+
+    // Point strictly inside a box (same convention as the CRTGeoAlg IsInside functions)
+    static bool Contains(const Box& box, double x, double y, double z){
+      return x > box.min[0] && x < box.max[0]
+          && y > box.min[1] && y < box.max[1]
+          && z > box.min[2] && z < box.max[2];
+    }
+
+    // Call f(index) for every box strictly containing the point
+    template<class F>
+    void Visit(double x, double y, double z, F&& f) const {
+      if(fNodes.empty()) return;
+      // Depth is bounded by the median split
+      int stack[64];
+      int nstack = 0;
+      stack[nstack++] = 0;
+      while(nstack){
+        const Node& node = fNodes[stack[--nstack]];
+        // Inclusive test on the node bounds, the strict test is done on the boxes
+        if(x < node.bounds.min[0] || x > node.bounds.max[0]
+           || y < node.bounds.min[1] || y > node.bounds.max[1]
+           || z < node.bounds.min[2] || z > node.bounds.max[2]) continue;
+        if(node.left < 0){
+          for(uint32_t i = node.begin; i < node.end; i++){
+            if(Contains(fBoxes[fOrder[i]], x, y, z)) f(fOrder[i]);
+          }
+          continue;
+        }
+        stack[nstack++] = node.left;
+        stack[nstack++] = node.right;
+      }
+    }
+
+  private:
+
+    struct Node{
+      Box bounds;
+      uint32_t begin;
+      uint32_t end;
+      int left;
+      int right;
+    };
+
+    static constexpr uint32_t kLeafSize = 4;
+
+    int Build(uint32_t begin, uint32_t end){
+      Node node;
+      node.begin = begin;
+      node.end = end;
+      node.left = -1;
+      node.right = -1;
+      node.bounds = fBoxes[fOrder[begin]];
+      for(uint32_t i = begin + 1; i < end; i++){
+        const Box& box = fBoxes[fOrder[i]];
+        for(size_t d = 0; d < 3; d++){
+          node.bounds.min[d] = std::min(node.bounds.min[d], box.min[d]);
+          node.bounds.max[d] = std::max(node.bounds.max[d], box.max[d]);
+        }
+      }
+
+      int index = fNodes.size();
+      fNodes.push_back(node);
+      if(end - begin <= kLeafSize) return index;
+
+      // Split at the median box centre along the longest axis
+      size_t axis = 0;
+      for(size_t d = 1; d < 3; d++){
+        if(node.bounds.max[d] - node.bounds.min[d] > node.bounds.max[axis] - node.bounds.min[axis]) axis = d;
+      }
+      uint32_t mid = begin + (end - begin) / 2;
+      std::nth_element(fOrder.begin() + begin, fOrder.begin() + mid, fOrder.begin() + end,
+                       [this, axis](uint32_t a, uint32_t b){
+                         return fBoxes[a].min[axis] + fBoxes[a].max[axis] < fBoxes[b].min[axis] + fBoxes[b].max[axis];
+                       });
+
+      int left = Build(begin, mid);
+      int right = Build(mid, end);
+      fNodes[index].left = left;
+      fNodes[index].right = right;
+      return index;
+    }
+
+    std::vector<Box> fBoxes;
+    std::vector<uint32_t> fOrder;
+    std::vector<Node> fNodes;
+  };
+
+}
+
+#endif
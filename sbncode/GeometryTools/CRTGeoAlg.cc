@@ -213,6 +213,83 @@ CRTGeoAlg::CRTGeoAlg(geo::GeometryCore const *geometry, geo::AuxDetGeometryCore
     fTaggers[taggerName].modules[moduleName] = module.second;
   }
 
+  BuildIndex();
+}
+
+// ----------------------------------------------------------------------------------
+// Build the dense index over the geometry maps
+void CRTGeoAlg::BuildIndex(){
+  std::vector<BoxBVH::Box> moduleBoxes;
+  std::vector<BoxBVH::Box> stripBoxes;
+
+  for(auto const& tagger : fTaggers){
+    fTaggerIndex[tagger.first] = fTaggerNames.size();
+    fTaggerNames.push_back(tagger.first);
+    fTaggerBoxes.push_back({{tagger.second.minX, tagger.second.minY, tagger.second.minZ},
+                            {tagger.second.maxX, tagger.second.maxY, tagger.second.maxZ}});
+  }
+
+  for(auto const& module : fModules){
+    fModuleIndex[module.first] = fModuleNames.size();
+    fModuleNames.push_back(module.first);
+    fModuleTagger.push_back(fTaggerIndex.at(module.second.tagger));
+    moduleBoxes.push_back({{module.second.minX, module.second.minY, module.second.minZ},
+                           {module.second.maxX, module.second.maxY, module.second.maxZ}});
+  }
+
+  for(auto const& strip : fStrips){
+    fStripIndex[strip.first] = fStripNames.size();
+    fStripNames.push_back(strip.first);
+    fStripModule.push_back(fModuleIndex.at(strip.second.module));
+    stripBoxes.push_back({{strip.second.minX, strip.second.minY, strip.second.minZ},
+                          {strip.second.maxX, strip.second.maxY, strip.second.maxZ}});
+  }
+
+  fModuleBVH = BoxBVH(moduleBoxes);
+  fStripBVH = BoxBVH(stripBoxes);
+
+  // Channels are 32 * auxdet + 2 * strip + (0, 1), so a dense array is small
+  CRTSipmGeo nullSipm = {};
+  nullSipm.null = true;
+  size_t nChannels = fSipms.empty() ? 0 : fSipms.rbegin()->first + 1;
+  fSipmByChannel.assign(nChannels, nullSipm);
+  fChannelStrip.assign(nChannels, InvalidIndex);
+  for(auto const& sipm : fSipms){
+    if(sipm.first < 0) continue;
+    fSipmByChannel[sipm.first] = sipm.second;
+    fChannelStrip[sipm.first] = fStripIndex.at(sipm.second.strip);
+  }
+
+  for(auto const& tagger : fTaggers){
+    for(auto const& module : tagger.second.modules){
+      for(auto const& strip : module.second.strips){
+        fStripCrossOrder.push_back(fStripIndex.at(strip.first));
+      }
+    }
+  }
+
+  if(!fTaggers.empty()){
+    std::vector<double> minXs;
+    std::vector<double> minYs;
+    std::vector<double> minZs;
+    std::vector<double> maxXs;
+    std::vector<double> maxYs;
+    std::vector<double> maxZs;
+    for(auto const& tagger : fTaggers){
+      minXs.push_back(tagger.second.minX);
+      minYs.push_back(tagger.second.minY);
+      minZs.push_back(tagger.second.minZ);
+      maxXs.push_back(tagger.second.maxX);
+      maxYs.push_back(tagger.second.maxY);
+      maxZs.push_back(tagger.second.maxZ);
+    }
+    fLimits.push_back(*std::min_element(minXs.begin(), minXs.end()));
+    fLimits.push_back(*std::min_element(minYs.begin(), minYs.end()));
+    fLimits.push_back(*std::min_element(minZs.begin(), minZs.end()));
+    fLimits.push_back(*std::max_element(maxXs.begin(), maxXs.end()));
+    fLimits.push_back(*std::max_element(maxYs.begin(), maxYs.end()));
+    fLimits.push_back(*std::max_element(maxZs.begin(), maxZs.end()));
+  }
 }
 
 
@@ -223,30 +300,7 @@ CRTGeoAlg::~CRTGeoAlg(){
 // ----------------------------------------------------------------------------------
 // Return the volume enclosed by the whole CRT system
 std::vector<double> CRTGeoAlg::CRTLimits() const {
-  std::vector<double> limits;
-
-  std::vector<double> minXs;
-  std::vector<double> minYs;
-  std::vector<double> minZs;
-  std::vector<double> maxXs;
-  std::vector<double> maxYs;
-  std::vector<double> maxZs;
-  for(auto const& tagger : fTaggers){
-    minXs.push_back(tagger.second.minX);
-    minYs.push_back(tagger.second.minY);
-    minZs.push_back(tagger.second.minZ);
-    maxXs.push_back(tagger.second.maxX);
-    maxYs.push_back(tagger.second.maxY);
-    maxZs.push_back(tagger.second.maxZ);
-  }
-  limits.push_back(*std::min_element(minXs.begin(), minXs.end()));
-  limits.push_back(*std::min_element(minYs.begin(), minYs.end()));
-  limits.push_back(*std::min_element(minZs.begin(), minZs.end()));
-  limits.push_back(*std::max_element(maxXs.begin(), maxXs.end()));
-  limits.push_back(*std::max_element(maxYs.begin(), maxYs.end()));
-  limits.push_back(*std::max_element(maxZs.begin(), maxZs.end()));
-
-  return limits;
+  return fLimits;
 }
 
 // ----------------------------------------------------------------------------------
@@ -307,9 +361,8 @@ size_t CRTGeoAlg::NumStrips(size_t tagger_i, size_t module_i) const{
 // ----------------------------------------------------------------------------------
 // Get the tagger geometry object by name
 CRTTaggerGeo CRTGeoAlg::GetTagger(std::string taggerName) const{
-  for(auto const& tagger : fTaggers){
-    if(taggerName == tagger.first) return tagger.second;
-  }
+  auto tagger = fTaggers.find(taggerName);
+  if(tagger != fTaggers.end()) return tagger->second;
   CRTTaggerGeo nullTagger = {};
   nullTagger.null = true;
   return nullTagger;
@@ -317,11 +370,7 @@ CRTTaggerGeo CRTGeoAlg::GetTagger(std::string taggerName) const{
 
 // Get the tagger geometry object by index
 CRTTaggerGeo CRTGeoAlg::GetTagger(size_t tagger_i) const{
-  size_t index = 0;
-  for(auto const& tagger : fTaggers){
-    if(tagger_i == index) return tagger.second;
-    index++;
-  }
+  if(tagger_i < fTaggerNames.size()) return fTaggers.at(fTaggerNames[tagger_i]);
   CRTTaggerGeo nullTagger = {};
   nullTagger.null = true;
   return nullTagger;
@@ -331,9 +380,8 @@ CRTTaggerGeo CRTGeoAlg::GetTagger(size_t tagger_i) const{
 // ----------------------------------------------------------------------------------
 // Get the module geometry object by name
 CRTModuleGeo CRTGeoAlg::GetModule(std::string moduleName) const{
-  for(auto const& module : fModules){
-    if(moduleName == module.first) return module.second;
-  }
+  auto module = fModules.find(moduleName);
+  if(module != fModules.end()) return module->second;
   CRTModuleGeo nullModule = {};
   nullModule.null = true;
   return nullModule;
@@ -341,11 +389,7 @@ CRTModuleGeo CRTGeoAlg::GetModule(std::string moduleName) const{
 
 // Get the module geometry object by global index
 CRTModuleGeo CRTGeoAlg::GetModule(size_t module_i) const{
-  size_t index = 0;
-  for(auto const& module : fModules){
-    if(module_i == index) return module.second;
-    index++;
-  }
+  if(module_i < fModuleNames.size()) return fModules.at(fModuleNames[module_i]);
   CRTModuleGeo nullModule = {};
   nullModule.null = true;
   return nullModule;
@@ -371,9 +415,8 @@ CRTModuleGeo CRTGeoAlg::GetModule(size_t tagger_i, size_t module_i) const{
 // ----------------------------------------------------------------------------------
 // Get the strip geometry object by name
 CRTStripGeo CRTGeoAlg::GetStrip(std::string stripName) const{
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first) return strip.second;
-  }
+  auto strip = fStrips.find(stripName);
+  if(strip != fStrips.end()) return strip->second;
   CRTStripGeo nullStrip = {};
   nullStrip.null = true;
   return nullStrip;
@@ -381,11 +424,7 @@ CRTStripGeo CRTGeoAlg::GetStrip(std::string stripName) const{
 
 // Get the strip geometry object by global index
 CRTStripGeo CRTGeoAlg::GetStrip(size_t strip_i) const{
-  size_t index = 0;
-  for(auto const& strip : fStrips){
-    if(strip_i == index) return strip.second;
-    index++;
-  }
+  if(strip_i < fStripNames.size()) return fStrips.at(fStripNames[strip_i]);
   CRTStripGeo nullStrip = {};
   nullStrip.null = true;
   return nullStrip;
@@ -437,10 +476,8 @@ std::string CRTGeoAlg::GetTaggerName(std::string name) const{
 
 // Get the name of the strip from the SiPM channel ID
 std::string CRTGeoAlg::ChannelToStripName(size_t channel) const{
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      return sipm.second.strip;
-    }
+  if(channel < fSipmByChannel.size() && !fSipmByChannel[channel].null){
+    return fSipmByChannel[channel].strip;
   }
   return "";
 }
@@ -472,11 +509,10 @@ std::vector<double> CRTGeoAlg::StripLimitsWithChargeSharing(std::string stripNam
 
 // Get the world position of Sipm from the channel ID
 geo::Point_t CRTGeoAlg::ChannelToSipmPosition(size_t channel) const{
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      geo::Point_t position {sipm.second.x, sipm.second.y, sipm.second.z};
-      return position;
-    }
+  if(channel < fSipmByChannel.size() && !fSipmByChannel[channel].null){
+    const CRTSipmGeo& sipm = fSipmByChannel[channel];
+    geo::Point_t position {sipm.x, sipm.y, sipm.z};
+    return position;
   }
   geo::Point_t null {-99999, -99999, -99999};
   return null;
@@ -484,9 +520,8 @@ geo::Point_t CRTGeoAlg::ChannelToSipmPosition(size_t channel) const{
 
 // Get the sipm channels on a strip
 std::pair<int, int> CRTGeoAlg::GetStripSipmChannels(std::string stripName) const{
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first) return strip.second.sipms;
-  }
+  auto strip = fStrips.find(stripName);
+  if(strip != fStrips.end()) return strip->second.sipms;
   return std::make_pair(-99999, -99999);
 }
 
@@ -494,19 +529,18 @@ std::pair<int, int> CRTGeoAlg::GetStripSipmChannels(std::string stripName) const
 double CRTGeoAlg::DistanceBetweenSipms(geo::Point_t position, size_t channel) const{
   double distance = -99999;
 
-  for(auto const& sipm : fSipms){
-    if(sipm.second.channel == channel){
-      geo::Point_t pos {sipm.second.x, sipm.second.y, sipm.second.z};
-      // Get the other sipm
-      int otherChannel = channel + 1;
-      if(channel % 2) otherChannel = channel - 1;
-      // Work out which coordinate is different
-      if(fSipms.at(otherChannel).x != pos.X()) distance = position.X() - pos.X();
-      if(fSipms.at(otherChannel).y != pos.Y()) distance = position.Y() - pos.Y();
-      if(fSipms.at(otherChannel).z != pos.Z()) distance = position.Z() - pos.Z();
-      // Return distance in that coordinate
-      return distance;
-    }
+  if(channel < fSipmByChannel.size() && !fSipmByChannel[channel].null){
+    const CRTSipmGeo& sipm = fSipmByChannel[channel];
+    geo::Point_t pos {sipm.x, sipm.y, sipm.z};
+    // Get the other sipm
+    int otherChannel = channel + 1;
+    if(channel % 2) otherChannel = channel - 1;
+    // Work out which coordinate is different
+    if(fSipms.at(otherChannel).x != pos.X()) distance = position.X() - pos.X();
+    if(fSipms.at(otherChannel).y != pos.Y()) distance = position.Y() - pos.Y();
+    if(fSipms.at(otherChannel).z != pos.Z()) distance = position.Z() - pos.Z();
+    // Return distance in that coordinate
+    return distance;
   }
   return distance;
 }
@@ -521,18 +555,17 @@ double CRTGeoAlg::DistanceBetweenSipms(geo::Point_t position, std::string stripN
 // Return the distance along the strip (from sipm end)
 double CRTGeoAlg::DistanceDownStrip(geo::Point_t position, std::string stripName) const{
   double distance = -99999;
-  for(auto const& strip : fStrips){
-    if(stripName == strip.first){
-      geo::Point_t pos = ChannelToSipmPosition(strip.second.sipms.first);
-      // Work out the longest dimension of strip
-      double xdiff = std::abs(strip.second.maxX-strip.second.minX);
-      double ydiff = std::abs(strip.second.maxY-strip.second.minY);
-      double zdiff = std::abs(strip.second.maxZ-strip.second.minZ);
-      if(xdiff > ydiff && xdiff > zdiff) distance = position.X() - pos.X();
-      if(ydiff > xdiff && ydiff > zdiff) distance = position.Y() - pos.Y();
-      if(zdiff > xdiff && zdiff > ydiff) distance = position.Z() - pos.Z();
-      return std::abs(distance);
-    }
+  auto strip = fStrips.find(stripName);
+  if(strip != fStrips.end()){
+    geo::Point_t pos = ChannelToSipmPosition(strip->second.sipms.first);
+    // Work out the longest dimension of strip
+    double xdiff = std::abs(strip->second.maxX-strip->second.minX);
+    double ydiff = std::abs(strip->second.maxY-strip->second.minY);
+    double zdiff = std::abs(strip->second.maxZ-strip->second.minZ);
+    if(xdiff > ydiff && xdiff > zdiff) distance = position.X() - pos.X();
+    if(ydiff > xdiff && ydiff > zdiff) distance = position.Y() - pos.Y();
+    if(zdiff > xdiff && zdiff > ydiff) distance = position.Z() - pos.Z();
+    return std::abs(distance);
   }
   return distance;
 }
@@ -545,7 +578,7 @@ bool CRTGeoAlg::IsInsideCRT(TVector3 point){
 }
 
 bool CRTGeoAlg::IsInsideCRT(geo::Point_t point){
-  std::vector<double> limits = CRTLimits();
+  const std::vector<double>& limits = fLimits;
   if(point.X() > limits[0] && point.Y() > limits[1] && point.Z() > limits[2]
      && point.X() < limits[3] && point.Y() < limits[4] && point.Z() < limits[5]){
     return true;
@@ -828,20 +861,91 @@ bool CRTGeoAlg::CrossesStrip(const CRTStripGeo& strip, const simb::MCParticle& p
 // Work out which strips the true particle crosses
 std::vector<std::string> CRTGeoAlg::CrossesStrips(const simb::MCParticle& particle){
   std::vector<std::string> stripNames;
-  for(auto const& tagger : fTaggers){
-    if(!CrossesTagger(tagger.second, particle)) continue;
-    for(auto const& module : tagger.second.modules){
-      if(!CrossesModule(module.second, particle)) continue;
-      for(auto const& strip : module.second.strips){
-        if(!CrossesStrip(strip.second, particle)) continue;
-        if(std::find(stripNames.begin(), stripNames.end(), strip.first) != stripNames.end()) continue;
-        stripNames.push_back(strip.first);
-      }
-    }
+  for(size_t strip_i : CrossesStripIndices(particle)){
+    stripNames.push_back(fStripNames[strip_i]);
   }
   return stripNames;
 }
 
+// ----------------------------------------------------------------------------------
+// Integer handles
+size_t CRTGeoAlg::TaggerIndex(const std::string& taggerName) const{
+  auto index = fTaggerIndex.find(taggerName);
+  return (index != fTaggerIndex.end()) ? index->second : InvalidIndex;
+}
+
+size_t CRTGeoAlg::ModuleIndex(const std::string& moduleName) const{
+  auto index = fModuleIndex.find(moduleName);
+  return (index != fModuleIndex.end()) ? index->second : InvalidIndex;
+}
+
+size_t CRTGeoAlg::StripIndex(const std::string& stripName) const{
+  auto index = fStripIndex.find(stripName);
+  return (index != fStripIndex.end()) ? index->second : InvalidIndex;
+}
+
+// Get the global index of the strip from the SiPM channel ID
+size_t CRTGeoAlg::ChannelToStripIndex(size_t channel) const{
+  if(channel < fChannelStrip.size()) return fChannelStrip[channel];
+  return InvalidIndex;
+}
+
+// ----------------------------------------------------------------------------------
+// Get the global indices of the modules containing a point
+std::vector<size_t> CRTGeoAlg::ModulesContaining(geo::Point_t point) const{
+  std::vector<size_t> modules;
+  fModuleBVH.Visit(point.X(), point.Y(), point.Z(), [&](size_t module_i){ modules.push_back(module_i); });
+  std::sort(modules.begin(), modules.end());
+  return modules;
+}
+
+// Get the global indices of the strips containing a point
+std::vector<size_t> CRTGeoAlg::StripsContaining(geo::Point_t point) const{
+  std::vector<size_t> strips;
+  fStripBVH.Visit(point.X(), point.Y(), point.Z(), [&](size_t strip_i){ strips.push_back(strip_i); });
+  std::sort(strips.begin(), strips.end());
+  return strips;
+}
+
+// ----------------------------------------------------------------------------------
+// Work out which strips the true particle crosses
+std::vector<size_t> CRTGeoAlg::CrossesStripIndices(const simb::MCParticle& particle) const{
+  // Mark the taggers containing a trajectory point, and the modules and strips
+  // containing a trajectory point or the midpoint to the next one (the same
+  // points as CrossesTagger, CrossesModule and CrossesStrip)
+  std::vector<char> taggerCrossed(fTaggerNames.size(), 0);
+  std::vector<char> moduleCrossed(fModuleNames.size(), 0);
+  std::vector<char> stripCrossed(fStripNames.size(), 0);
+
+  auto markModules = [&](size_t module_i){ moduleCrossed[module_i] = 1; };
+  auto markStrips = [&](size_t strip_i){ stripCrossed[strip_i] = 1; };
+
+  size_t nPoints = particle.NumberTrajectoryPoints();
+  for(size_t i = 0; i < nPoints; i++){
+    geo::Point_t point {particle.Vx(i), particle.Vy(i), particle.Vz(i)};
+    for(size_t tagger_i = 0; tagger_i < fTaggerBoxes.size(); tagger_i++){
+      if(BoxBVH::Contains(fTaggerBoxes[tagger_i], point.X(), point.Y(), point.Z())) taggerCrossed[tagger_i] = 1;
+    }
+    fModuleBVH.Visit(point.X(), point.Y(), point.Z(), markModules);
+    fStripBVH.Visit(point.X(), point.Y(), point.Z(), markStrips);
+
+    if(i == nPoints-1) continue;
+    geo::Point_t next {particle.Vx(i+1), particle.Vy(i+1), particle.Vz(i+1)};
+    geo::Point_t mid {(point.X()+next.X())/2, (point.Y()+next.Y())/2, (point.Z()+next.Z())/2};
+    fModuleBVH.Visit(mid.X(), mid.Y(), mid.Z(), markModules);
+    fStripBVH.Visit(mid.X(), mid.Y(), mid.Z(), markStrips);
+  }
+
+  std::vector<size_t> strips;
+  for(size_t strip_i : fStripCrossOrder){
+    if(!stripCrossed[strip_i]) continue;
+    size_t module_i = fStripModule[strip_i];
+    if(!moduleCrossed[module_i] || !taggerCrossed[fModuleTagger[module_i]]) continue;
+    strips.push_back(strip_i);
+  }
+  return strips;
+}
+
 
 // ----------------------------------------------------------------------------------
 // Find the angle of true particle trajectory to tagger
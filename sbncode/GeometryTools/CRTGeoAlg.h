@@ -28,7 +28,12 @@
 #include "nusimdata/SimulationBase/MCParticle.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 
+// local
+#include "sbncode/GeometryTools/BoxBVH.h"
+
 // c++
+#include <limits>
+#include <unordered_map>
 #include <vector>
 
 // ROOT
@@ -205,6 +210,22 @@ namespace sbn{
     // Work out which strips the true particle crosses
     std::vector<std::string> CrossesStrips(const simb::MCParticle& particle);
 
+    // Integer handles: global index of a tagger, module or strip by name, in the same
+    // order as the index based getters above, or InvalidIndex if there is no such object
+    static constexpr size_t InvalidIndex = std::numeric_limits<size_t>::max();
+    size_t TaggerIndex(const std::string& taggerName) const;
+    size_t ModuleIndex(const std::string& moduleName) const;
+    size_t StripIndex(const std::string& stripName) const;
+    // Get the global index of the strip from the SiPM channel ID
+    size_t ChannelToStripIndex(size_t channel) const;
+
+    // Get the global indices of the modules/strips containing a point
+    std::vector<size_t> ModulesContaining(geo::Point_t point) const;
+    std::vector<size_t> StripsContaining(geo::Point_t point) const;
+
+    // Global indices of the strips the true particle crosses, in the order of CrossesStrips
+    std::vector<size_t> CrossesStripIndices(const simb::MCParticle& particle) const;
+
     // Find the angle of true particle trajectory to tagger
     double AngleToTagger(std::string taggerName, const simb::MCParticle& particle);
 
@@ -224,6 +245,29 @@ namespace sbn{
     std::map<std::string, CRTStripGeo> fStrips;
     std::map<int, CRTSipmGeo> fSipms;
 
+    // Index over the maps above, built once by BuildIndex
+    void BuildIndex();
+    // Names by global index (map order) and the reverse lookup
+    std::vector<std::string> fTaggerNames;
+    std::vector<std::string> fModuleNames;
+    std::vector<std::string> fStripNames;
+    std::unordered_map<std::string, size_t> fTaggerIndex;
+    std::unordered_map<std::string, size_t> fModuleIndex;
+    std::unordered_map<std::string, size_t> fStripIndex;
+    // Parent of each module/strip by global index
+    std::vector<size_t> fModuleTagger;
+    std::vector<size_t> fStripModule;
+    // SiPMs and their strip by channel ID (null SiPM for unused channels)
+    std::vector<CRTSipmGeo> fSipmByChannel;
+    std::vector<size_t> fChannelStrip;
+    // Strip indices in tagger -> module -> strip map order
+    std::vector<size_t> fStripCrossOrder;
+    // Boxes of the taggers, and hierarchies over the module and strip boxes
+    std::vector<BoxBVH::Box> fTaggerBoxes;
+    BoxBVH fModuleBVH;
+    BoxBVH fStripBVH;
+    std::vector<double> fLimits;
+
     geo::GeometryCore const* fGeometryService;
     const geo::AuxDetGeometryCore* fAuxDetGeoCore;
 
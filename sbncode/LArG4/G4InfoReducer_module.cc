@@ -24,11 +24,95 @@
 #include "larcore/CoreUtils/ServiceUtil.h" // for lar::providerFrom
 #include "lardata/DetectorInfoServices/DetectorPropertiesServiceStandard.h" // for DetectorClocksService
 
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <memory>
-#include <set>
+#include <vector>
 
 class G4InfoReducer;
 
+namespace {
+
+  /// Same ordering as the std::set of deposits the module used to fill
+  struct SEDLiteLess {
+    bool operator() (sim::SimEnergyDepositLite const& lhs, sim::SimEnergyDepositLite const& rhs) const {
+      if (lhs.X() < rhs.X()) return true;
+      if (lhs.X() > rhs.X()) return false;
+      if (lhs.Y() < rhs.Y()) return true;
+      if (lhs.Y() > rhs.Y()) return false;
+      if (lhs.Z() < rhs.Z()) return true;
+      if (lhs.Z() > rhs.Z()) return false;
+      return lhs.TrackID() < rhs.TrackID();
+    }
+  };
+
+  /**
+   * Open-addressing (linear probing) hash table of voxelized deposits, keyed on
+   * the voxel position and track ID. A deposit landing on an existing key is
+   * merged into it exactly as the std::set implementation did: the energies are
+   * summed in insertion order and the earliest time is kept.
+   */
+  class VoxelAccumulator {
+  public:
+    struct Entry {
+      uint64_t hash;
+      sim::SimEnergyDepositLite sed;
+    };
+
+    VoxelAccumulator() { Clear(); }
+
+    void Clear() {
+      fSlots.assign(1024, -1);
+      fEntries.clear();
+    }
+
+    void Add(uint64_t hash, sim::SimEnergyDepositLite const& sed) {
+      size_t const mask = fSlots.size() - 1;
+      size_t i = hash & mask;
+      while (fSlots[i] >= 0) {
+        Entry& entry = fEntries[fSlots[i]];
+        if (entry.hash == hash && SameKey(entry.sed, sed)) {
+          double new_energy = sed.E() + entry.sed.E();
+          double new_time = std::min(sed.T(), entry.sed.T());
+          entry.sed = sim::SimEnergyDepositLite(new_energy, geo::Point_t(sed.X(), sed.Y(), sed.Z()), new_time, sed.TrackID());
+          return;
+        }
+        i = (i + 1) & mask;
+      }
+
+      fSlots[i] = fEntries.size();
+      fEntries.push_back({hash, sed});
+      // keep the load factor below 1/2
+      if (2 * fEntries.size() > fSlots.size()) Grow();
+    }
+
+    std::vector<Entry> const& Entries() const { return fEntries; }
+
+  private:
+    static bool SameKey(sim::SimEnergyDepositLite const& lhs, sim::SimEnergyDepositLite const& rhs) {
+      return lhs.X() == rhs.X() && lhs.Y() == rhs.Y() && lhs.Z() == rhs.Z() && lhs.TrackID() == rhs.TrackID();
+    }
+
+    void Grow() {
+      fSlots.assign(2 * fSlots.size(), -1);
+      size_t const mask = fSlots.size() - 1;
+      for (size_t ientry = 0; ientry < fEntries.size(); ++ientry) {
+        size_t i = fEntries[ientry].hash & mask;
+        while (fSlots[i] >= 0) i = (i + 1) & mask;
+        fSlots[i] = ientry;
+      }
+    }
+
+    std::vector<int64_t> fSlots; ///< index into fEntries, -1 if empty; size is a power of two
+    std::vector<Entry> fEntries; ///< unique deposits, in order of first insertion
+  };
+
+} // namespace
+
 
 class G4InfoReducer : public art::EDProducer {
 public:
@@ -51,6 +135,8 @@ private:
   art::InputTag fSedLabel; ///< module making the SimEnergyDeposit
   double fMinX, fMinY, fMinZ; ///< bottom left coordinate of union of all TPC active volumes
   double fVoxelSizeX, fVoxelSizeY, fVoxelSizeZ; ///< size of a voxel (cm)
+  unsigned fNumThreads; ///< number of threads merging deposits (the output does not depend on it)
+  tbb::task_arena fArena; ///< arena of the merging threads, initialized if NumThreads > 1
   //services
   const geo::GeometryCore& fGeometry;
 };
@@ -71,6 +157,13 @@ G4InfoReducer::G4InfoReducer(fhicl::ParameterSet const& p)
     throw std::exception();
   }
 
+  fNumThreads = p.get<unsigned>("NumThreads", 1);
+  if (fNumThreads == 0) {
+    std::cerr << "NumThreads must be at least one." << std::endl;
+    throw std::exception();
+  }
+  if (fNumThreads > 1) fArena.initialize(fNumThreads);
+
   double min_x = std::numeric_limits<double>::max();
   double min_y = std::numeric_limits<double>::max();
   double min_z = std::numeric_limits<double>::max();
@@ -108,19 +201,6 @@ void G4InfoReducer::produce(art::Event& e)
     throw std::exception();
   }
 
-  struct comp {
-    bool operator() (sim::SimEnergyDepositLite lhs, sim::SimEnergyDepositLite rhs) const {
-      if (lhs.X() < rhs.X()) return true;
-      if (lhs.X() > rhs.X()) return false;
-      if (lhs.Y() < rhs.Y()) return true;
-      if (lhs.Y() > rhs.Y()) return false;
-      if (lhs.Z() < rhs.Z()) return true;
-      if (lhs.Z() > rhs.Z()) return false;
-      return lhs.TrackID() < rhs.TrackID();
-    }
-  };
-  std::set<sim::SimEnergyDepositLite, comp> sedlite_v2;
-
   auto const& sed_v = *handle;
 
   /*double total_edep = 0.;
@@ -129,41 +209,87 @@ void G4InfoReducer::produce(art::Event& e)
   }
   std::cout << "total edep = " << total_edep << " count = " << sed_v.size() << std::endl;*/
 
-  for (size_t idx = 0; idx < sed_v.size(); ++idx) {
-    auto const& sed = sed_v[idx];
-    // Voxelize coordinates to closest coordinate using fVoxelSize
+  // Voxelize coordinates to closest coordinate using fVoxelSize, and copy info to SimEnergyDepositLite
+  auto voxelize = [this](sim::SimEnergyDeposit const& sed) {
     double x = sed.X() - std::fmod(sed.X() - fMinX, fVoxelSizeX);
     double y = sed.Y() - std::fmod(sed.Y() - fMinY, fVoxelSizeY);
     double z = sed.Z() - std::fmod(sed.Z() - fMinZ, fVoxelSizeZ);
-    // Copy info to SimEnergyDepositLite
-    sim::SimEnergyDepositLite sed_lite(sed.E(), geo::Point_t(x, y, z), sed.T(), sed.OrigTrackID());
-    // Attempt to insert, if already exist we sum up energy deposit
-    auto it = sedlite_v2.find(sed_lite);
-    if (it!=sedlite_v2.end()) {
-      double new_energy = sed_lite.E() + it->E();
-      double new_time = std::min(sed_lite.T(), it->T());
-      sedlite_v2.erase(it);
-      sim::SimEnergyDepositLite new_sed_lite(new_energy, geo::Point_t(x, y, z), new_time, sed.OrigTrackID());
-      sedlite_v2.insert(new_sed_lite);
-    }
-    else {
-      sedlite_v2.insert(std::move(sed_lite));
+    return sim::SimEnergyDepositLite(sed.E(), geo::Point_t(x, y, z), sed.T(), sed.OrigTrackID());
+  };
+
+  // Hash of the integer voxel indices and track ID. Deposits that compare equal
+  // always have the same indices, so they always land in the same bucket
+  auto hash = [this](sim::SimEnergyDepositLite const& sed) {
+    uint64_t h = static_cast<uint64_t>(std::llround((sed.X() - fMinX) / fVoxelSizeX));
+    h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(std::llround((sed.Y() - fMinY) / fVoxelSizeY));
+    h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(std::llround((sed.Z() - fMinZ) / fVoxelSizeZ));
+    h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(static_cast<uint32_t>(sed.TrackID()));
+    // mix the high bits down (splitmix64 finalizer)
+    h ^= h >> 30; h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27; h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+  };
+
+  // Sum up energy deposits in the same voxel from the same track.
+  //
+  // With several threads, the input is split into contiguous chunks. Each
+  // chunk is voxelized by one thread, which sorts its deposits into one bucket
+  // per hash partition. Each partition is then owned by one thread, which
+  // merges its buckets chunk by chunk: every voxel sees the same sequence of
+  // additions as in the serial case, and each deposit is visited once per step.
+  unsigned const nparts = std::min<size_t>(fNumThreads, std::max<size_t>(sed_v.size(), 1));
+  std::vector<VoxelAccumulator> accumulators(nparts);
+  if (nparts == 1) {
+    for (size_t idx = 0; idx < sed_v.size(); ++idx) {
+      sim::SimEnergyDepositLite sed_lite = voxelize(sed_v[idx]);
+      accumulators[0].Add(hash(sed_lite), sed_lite);
     }
   }
+  else {
+    size_t const nchunks = nparts;
+    // buckets[ichunk * nparts + ipart]: deposits of a chunk falling in a partition, in input order
+    std::vector<std::vector<VoxelAccumulator::Entry>> buckets(nchunks * nparts);
+    fArena.execute([&]() {
+      tbb::parallel_for(size_t(0), nchunks, [&](size_t ichunk) {
+        size_t const begin = sed_v.size() * ichunk / nchunks;
+        size_t const end = sed_v.size() * (ichunk + 1) / nchunks;
+        auto bucket = buckets.begin() + ichunk * nparts;
+        for (size_t idx = begin; idx < end; ++idx) {
+          sim::SimEnergyDepositLite sed_lite = voxelize(sed_v[idx]);
+          uint64_t const h = hash(sed_lite);
+          bucket[(h >> 32) % nparts].push_back({h, sed_lite});
+        }
+      });
+      tbb::parallel_for(size_t(0), size_t(nparts), [&](size_t ipart) {
+        for (size_t ichunk = 0; ichunk < nchunks; ++ichunk) {
+          for (auto const& v : buckets[ichunk * nparts + ipart]) accumulators[ipart].Add(v.hash, v.sed);
+        }
+      });
+    });
+  }
+
+  // Create vector for SEDLite, in the order of the std::set used before
+  size_t count = 0;
+  for (auto const& acc : accumulators) count += acc.Entries().size();
+  std::unique_ptr<std::vector<sim::SimEnergyDepositLite>> sedlite_v(new std::vector<sim::SimEnergyDepositLite>);
+  sedlite_v->reserve(count);
+  for (auto const& acc : accumulators) {
+    for (auto const& entry : acc.Entries()) sedlite_v->push_back(entry.sed);
+  }
+  // keys are unique, so the order does not depend on the partitioning
+  std::sort(sedlite_v->begin(), sedlite_v->end(), SEDLiteLess());
 
   /*double new_total_edep = 0.;
   int counts = 0;
 
-  for (auto it : sedlite_v2) {
+  for (auto const& it : *sedlite_v) {
     new_total_edep += it.E();
     counts += 1;
   }
-  std::cout << "new total edep = " << new_total_edep << " with counts " << counts << " " << sedlite_v2.size() << std::endl;
+  std::cout << "new total edep = " << new_total_edep << " with counts " << counts << " " << sedlite_v->size() << std::endl;
   */
 
-  // Create vector for SEDLite
-  std::unique_ptr<std::vector<sim::SimEnergyDepositLite>> sedlite_v(new std::vector<sim::SimEnergyDepositLite>(sedlite_v2.begin(), sedlite_v2.end()));
-
   // Store SEDLite in event
   e.put(std::move(sedlite_v));
 
@@ -0,0 +1,59 @@
+#include "EnergyLossTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace trkf::sbn;
+
+namespace {
+  // lowest kinetic energy in the table [GeV]; below it the range is taken linear in the energy
+  constexpr double kMinKE = 1.e-5;
+  // floor on the energy loss, to keep the range finite where the loss function vanishes [GeV/cm]
+  constexpr double kMinDeDx = 1.e-6;
+}
+
+EnergyLossTable::EnergyLossTable(double mass, std::function<double(double)> dedx, double maxKE, unsigned npoints)
+  : fMass(mass)
+{
+  npoints = std::max(npoints, 2u);
+  auto invdedx = [&](double ke) { return 1./std::max(dedx(fMass + ke), kMinDeDx); };
+
+  const double dlog = std::log(maxKE/kMinKE)/(npoints - 1);
+  fKE.resize(npoints);
+  fRange.resize(npoints);
+  for (unsigned i = 0; i < npoints; i++) fKE[i] = kMinKE*std::exp(dlog*i);
+
+  fRange[0] = kMinKE*invdedx(kMinKE);
+  for (unsigned i = 1; i < npoints; i++) {
+    // Simpson's rule on each grid interval
+    const double a = fKE[i-1];
+    const double b = fKE[i];
+    fRange[i] = fRange[i-1] + (b - a)/6.*(invdedx(a) + 4.*invdedx(0.5*(a + b)) + invdedx(b));
+  }
+}
+
+double EnergyLossTable::Range(double E) const {
+  const double ke = E - fMass;
+  if (ke <= 0.) return 0.;
+  if (ke <= fKE.front()) return fRange.front()*ke/fKE.front();
+  // the grid is uniform in log(KE), so the interval is found directly
+  const double dlog = std::log(fKE.back()/fKE.front())/(fKE.size() - 1);
+  size_t i = std::min(size_t(std::log(ke/fKE.front())/dlog), fKE.size() - 2);
+  const double f = (ke - fKE[i])/(fKE[i+1] - fKE[i]);
+  return fRange[i] + f*(fRange[i+1] - fRange[i]);
+}
+
+double EnergyLossTable::Energy(double r) const {
+  if (r <= 0.) return fMass;
+  if (r <= fRange.front()) return fMass + fKE.front()*r/fRange.front();
+  size_t i = std::upper_bound(fRange.begin(), fRange.end(), r) - fRange.begin();
+  i = std::min(i, fRange.size() - 1) - 1;
+  const double f = (r - fRange[i])/(fRange[i+1] - fRange[i]);
+  return fMass + fKE[i] + f*(fKE[i+1] - fKE[i]);
+}
+
+double EnergyLossTable::EnergyAfter(double E, double length) const {
+  const double r = Range(E) - length;
+  if (r <= 0.) return 0.;
+  return Energy(r);
+}
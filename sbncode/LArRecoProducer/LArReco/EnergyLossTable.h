@@ -0,0 +1,47 @@
+#ifndef ENERGYLOSSTABLE_H
+#define ENERGYLOSSTABLE_H
+
+#include <functional>
+#include <vector>
+
+namespace trkf::sbn {
+  /**
+   * @file  sbncode/LArRecoProducer/LArReco/EnergyLossTable.h
+   * @class trkf::sbn::EnergyLossTable
+   *
+   * @brief Range-energy table of a particle for a given energy loss per unit length
+   *
+   * The residual range is integrated once, on a grid of kinetic energies
+   * spaced logarithmically, from the energy loss function. The energy left
+   * after travelling a distance is then two lookups: the range at the initial
+   * energy, and the energy at that range minus the distance. Both directions
+   * interpolate linearly between grid points, and the range is monotonic in
+   * the energy, so the inversion is a binary search.
+   *
+   * Energies are total energies in GeV, lengths in cm.
+   */
+  class EnergyLossTable {
+  public:
+    /// @param mass       particle mass [GeV]
+    /// @param dedx       energy loss per unit length [GeV/cm] at a total energy [GeV]
+    /// @param maxKE      largest kinetic energy in the table [GeV]
+    /// @param npoints    number of grid points
+    EnergyLossTable(double mass, std::function<double(double)> dedx, double maxKE = 20., unsigned npoints = 2000);
+
+    double Mass() const { return fMass; }
+
+    /// Residual range of a particle of total energy E
+    double Range(double E) const;
+    /// Total energy of a particle with residual range r
+    double Energy(double r) const;
+    /// Total energy after travelling a length, or 0 if the particle stops
+    double EnergyAfter(double E, double length) const;
+
+  private:
+    double fMass;
+    std::vector<double> fKE;    ///< kinetic energy grid
+    std::vector<double> fRange; ///< residual range at each grid point
+  };
+}
+
+#endif
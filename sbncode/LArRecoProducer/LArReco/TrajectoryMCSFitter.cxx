@@ -8,19 +8,20 @@ using namespace std;
 using namespace trkf::sbn;
 using namespace recob::tracking;
 
-recob::MCSFitResult TrajectoryMCSFitter::fitMcs(const recob::TrackTrajectory& traj, int pid, bool momDepConst) const {
+TrajectoryMCSFitter::Segmentation TrajectoryMCSFitter::segmentTrajectory(const recob::TrackTrajectory& traj) const {
   //
   // Break the trajectory in segments of length approximately equal to segLen_
   //
+  Segmentation seg;
   vector<size_t> breakpoints;
-  vector<float> segradlengths;
+  vector<float>& segradlengths = seg.segradlengths;
   vector<float> cumseglens;
   breakTrajInSegments(traj, breakpoints, segradlengths, cumseglens);
   //
   // Fit segment directions, and get 3D angles between them
   //
-  if (segradlengths.size()<2) return recob::MCSFitResult();
-  vector<float> dtheta;
+  if (segradlengths.size()<2) return seg;
+  vector<float>& dtheta = seg.dtheta;
   Vector_t pcdir0;
   Vector_t pcdir1;
   for (unsigned int p = 0; p<segradlengths.size(); p++) {
@@ -39,21 +40,27 @@ recob::MCSFitResult TrajectoryMCSFitter::fitMcs(const recob::TrackTrajectory& tr
     pcdir0 = pcdir1;
   }
   //
-  // Perform likelihood scan in forward and backward directions
+  // Cumulative lengths for the forward and backward directions
   //
-  vector<float> cumLenFwd;
-  vector<float> cumLenBwd;
   for (unsigned int i = 0; i<cumseglens.size()-2; i++) {
-    cumLenFwd.push_back(cumseglens[i]);
-    cumLenBwd.push_back(cumseglens.back()-cumseglens[i+2]);
+    seg.cumLenFwd.push_back(cumseglens[i]);
+    seg.cumLenBwd.push_back(cumseglens.back()-cumseglens[i+2]);
   }
-  const ScanResult fwdResult = doLikelihoodScan(dtheta, segradlengths, cumLenFwd, true,  momDepConst, pid);
-  const ScanResult bwdResult = doLikelihoodScan(dtheta, segradlengths, cumLenBwd, false, momDepConst, pid);
+  return seg;
+}
+
+recob::MCSFitResult TrajectoryMCSFitter::fitMcs(const Segmentation& seg, int pid, bool momDepConst) const {
+  if (seg.segradlengths.size()<2) return recob::MCSFitResult();
+  //
+  // Perform likelihood scan in forward and backward directions
+  //
+  const ScanResult fwdResult = doLikelihoodScan(seg.dtheta, seg.segradlengths, seg.cumLenFwd, true,  momDepConst, pid);
+  const ScanResult bwdResult = doLikelihoodScan(seg.dtheta, seg.segradlengths, seg.cumLenBwd, false, momDepConst, pid);
   //
   return recob::MCSFitResult(pid,
                             fwdResult.p,fwdResult.pUnc,fwdResult.logL,
                             bwdResult.p,bwdResult.pUnc,bwdResult.logL,
-                            segradlengths,dtheta);
+                            seg.segradlengths,seg.dtheta);
 }
 
 void TrajectoryMCSFitter::breakTrajInSegments(const recob::TrackTrajectory& traj, vector<size_t>& breakpoints, vector<float>& segradlengths, vector<float>& cumseglens) const {
@@ -95,40 +102,65 @@ void TrajectoryMCSFitter::breakTrajInSegments(const recob::TrackTrajectory& traj
   return;
 }
 
-const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(std::vector<float>& dtheta, std::vector<float>& seg_nradlengths, std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const {
+const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(const std::vector<float>& dtheta, const std::vector<float>& seg_nradlengths, const std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const {
+  //
+  // The likelihood is evaluated on demand at the momentum values of the scan
+  //
+  const int nscan = pScan_.size();
+  std::vector<float> vlogL(nscan);
+  std::vector<bool> done(nscan, false);
   int    best_idx  = -1;
   double best_logL = std::numeric_limits<double>::max();
-  double best_p    = -1.0;
-  std::vector<float> vlogL;
-  for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) {
-    double logL = mcsLikelihood(p_test, angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
-    if (logL < best_logL) {
-      best_p    = p_test;
+  auto test = [&](int j) {
+    if (j<0 || j>=nscan || done[j]) return;
+    double logL = mcsLikelihood(pScan_[j], angResol_, dtheta, seg_nradlengths, cumLen, fwdFit, momDepConst, pid);
+    vlogL[j] = logL;
+    done[j] = true;
+    // the first value wins ties, as in a scan from pMin_
+    if (logL < best_logL || (logL == best_logL && j < best_idx)) {
       best_logL = logL;
-      best_idx  = vlogL.size();
+      best_idx  = j;
     }
-    vlogL.push_back(logL);
+  };
+  //
+  // coarse scan, then the full steps around its minimum
+  //
+  for (int j = 0; j < nscan; j+=scanCoarseStride_) test(j);
+  test(nscan-1);
+  if (best_idx<0) {
+    for (int j = 0; j < nscan; j++) test(j);
+  }
+  if (best_idx<0) return ScanResult(-1.0, -1.0, best_logL);
+  const int coarse_idx = best_idx;
+  for (int j = coarse_idx-scanCoarseStride_+1; j < coarse_idx+scanCoarseStride_; j++) test(j);
+  //
+  // follow the likelihood downhill until both neighbours of the minimum are known
+  //
+  while (true) {
+    const int prev_idx = best_idx;
+    test(best_idx-1);
+    test(best_idx+1);
+    if (best_idx==prev_idx) break;
   }
+  const double best_p = pScan_[best_idx];
   //
   //uncertainty from left side scan
   double lunc = -1.0;
-  if (best_idx>0) {
-    for (int j=best_idx-1;j>=0;j--) {
-      double dLL = vlogL[j]-vlogL[best_idx];
-      if ( dLL<0.5 ) {
-        lunc = (best_idx-j)*pStep_;
-      } else break;
-    }
+  for (int j=best_idx-1;j>=0;j--) {
+    test(j);
+    double dLL = vlogL[j]-vlogL[best_idx];
+    if ( dLL<0.5 ) {
+      lunc = (best_idx-j)*pStep_;
+    } else break;
   }
   //uncertainty from right side scan
   double runc = -1.0;
-  if (best_idx<int(vlogL.size()-1)) {  
-    for (unsigned int j=best_idx+1;j<vlogL.size();j++) {
-      double dLL = vlogL[j]-vlogL[best_idx];
-      if ( dLL<0.5 ) {
-        runc = (j-best_idx)*pStep_;
-      } else break;
-    }
+  for (int j=best_idx+1;j<nscan;j++) {
+    test(j);
+    double dLL = vlogL[j]-vlogL[best_idx];
+    if ( dLL<0.5 ) {
+      runc = (j-best_idx)*pStep_;
+    } else break;
   }
   return ScanResult(best_p, std::max(lunc,runc), best_logL);
 }
@@ -185,7 +217,7 @@ void TrajectoryMCSFitter::linearRegression(const recob::TrackTrajectory& traj, c
   //
 }
 
-double TrajectoryMCSFitter::mcsLikelihood(double p, double theta0x, std::vector<float>& dthetaij, std::vector<float>& seg_nradl, std::vector<float>& cumLen, bool fwd, bool momDepConst, int pid) const {
+double TrajectoryMCSFitter::mcsLikelihood(double p, double theta0x, const std::vector<float>& dthetaij, const std::vector<float>& seg_nradl, const std::vector<float>& cumLen, bool fwd, bool momDepConst, int pid) const {
   //
   const int beg  = (fwd ? 0 : (dthetaij.size()-1));
   const int end  = (fwd ? dthetaij.size() : -1);
@@ -280,7 +312,30 @@ double TrajectoryMCSFitter::energyLossBetheBloch(const double mass,const double
   return dedx;
 }
 //
+void TrajectoryMCSFitter::buildELossTables() {
+  //
+  // one table per particle hypothesis, with the loss used by GetE in this mode
+  //
+  if (eLossMode_==1) return;
+  const double maxKE = std::max(20., 2.*pMax_);
+  for (int pid : {13, 211, 321, 2212}) {
+    const double m = mass(pid);
+    const double m2 = m*m;
+    if (eLossMode_==2) {
+      // same arguments as the Bethe-Bloch call in GetE
+      eLossTables_.emplace_back(m, [this, m](double E) { return energyLossBetheBloch(m,E); }, maxKE);
+    } else {
+      // the MPV loss is not proportional to the thickness, take the one of a nominal segment
+      eLossTables_.emplace_back(m, [this, m2](double E) { return energyLossLandau(m2,E*E,segLen_)/segLen_; }, maxKE);
+    }
+  }
+}
+//
 double TrajectoryMCSFitter::GetE(const double initial_E, const double length_travelled, const double m) const {
+  //
+  for (const EnergyLossTable& table : eLossTables_) {
+    if (table.Mass()==m) return table.EnergyAfter(initial_E, length_travelled);
+  }
   //
   const double step_size = length_travelled / nElossSteps_;
   //
@@ -8,6 +8,10 @@
 #include "lardataobj/RecoBase/MCSFitResult.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardata/RecoObjects/TrackState.h"
+#include "EnergyLossTable.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace trkf::sbn {
   /**
@@ -87,10 +91,20 @@ namespace trkf::sbn {
         Comment("Angular resolution parameter used in modified Highland formula. Unit is mrad."),
         3.0
       };
+      fhicl::Atom<int> scanCoarseStride {
+        Name("scanCoarseStride"),
+        Comment("Scan every Nth momentum value first, then the full-step values around the coarse minimum, following the likelihood downhill. Gives the full scan result when the likelihood has a single minimum at this granularity, but may find another minimum otherwise. 1 (default) scans every value."),
+        1
+      };
+      fhicl::Atom<bool> eLossTable {
+        Name("eLossTable"),
+        Comment("Compute the energy upstream of each segment from a range-energy table built once per particle, instead of nElossSteps steps. In the Landau mode the table uses the MPV loss over segmentLength."),
+        false
+      };
     };
     using Parameters = fhicl::Table<Config>;
     //
-    TrajectoryMCSFitter(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol){
+    TrajectoryMCSFitter(int pIdHyp, int minNSegs, double segLen, int minHitsPerSegment, int nElossSteps, int eLossMode, double pMin, double pMax, double pStep, double angResol, int scanCoarseStride = 1, bool eLossTable = false){
       pIdHyp_ = pIdHyp;
       minNSegs_ = minNSegs;
       segLen_ = segLen;
@@ -101,15 +115,31 @@ namespace trkf::sbn {
       pMax_ = pMax;
       pStep_ = pStep;
       angResol_ = angResol;
+      scanCoarseStride_ = std::max(scanCoarseStride,1);
+      // momentum values of the likelihood scan
+      for (double p_test = pMin_; p_test <= pMax_; p_test+=pStep_) pScan_.push_back(p_test);
+      if (eLossTable) buildELossTables();
     }
     explicit TrajectoryMCSFitter(const Parameters & p)
-      : TrajectoryMCSFitter(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol()) {}
+      : TrajectoryMCSFitter(p().pIdHypothesis(),p().minNumSegments(),p().segmentLength(),p().minHitsPerSegment(),p().nElossSteps(),p().eLossMode(),p().pMin(),p().pMax(),p().pStep(),p().angResol(),p().scanCoarseStride(),p().eLossTable()) {}
+    //
+    /// Segment lengths and scattering angles of a trajectory, which do not depend on the PID hypothesis
+    struct Segmentation {
+      std::vector<float> segradlengths;
+      std::vector<float> dtheta;
+      std::vector<float> cumLenFwd;
+      std::vector<float> cumLenBwd;
+    };
+    Segmentation segmentTrajectory(const recob::TrackTrajectory& traj) const;
+    Segmentation segmentTrajectory(const recob::Track& track) const { return segmentTrajectory(track.Trajectory()); }
+    /// Fit from a segmentation computed once per track, to be shared by several PID hypotheses
+    recob::MCSFitResult fitMcs(const Segmentation& seg, int pid, bool momDepConst = true) const;
     //
     recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj, bool momDepConst = true) const { return fitMcs(traj,pIdHyp_,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Track& track,          bool momDepConst = true) const { return fitMcs(track,pIdHyp_,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Trajectory& traj,      bool momDepConst = true) const { return fitMcs(traj,pIdHyp_,momDepConst); }
     //
-    recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj, int pid, bool momDepConst = true) const;
+    recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj, int pid, bool momDepConst = true) const { return fitMcs(segmentTrajectory(traj),pid,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Track& track,          int pid, bool momDepConst = true) const { return fitMcs(track.Trajectory(),pid,momDepConst); }
     recob::MCSFitResult fitMcs(const recob::Trajectory& traj,      int pid, bool momDepConst = true) const {
       recob::TrackTrajectory::Flags_t flags(traj.NPoints());
@@ -119,7 +149,7 @@ namespace trkf::sbn {
     //
     void breakTrajInSegments(const recob::TrackTrajectory& traj, std::vector<size_t>& breakpoints, std::vector<float>& segradlengths, std::vector<float>& cumseglens) const;
     void linearRegression(const recob::TrackTrajectory& traj, const size_t firstPoint, const size_t lastPoint, recob::tracking::Vector_t& pcdir) const;
-    double mcsLikelihood(double p, double theta0x, std::vector<float>& dthetaij, std::vector<float>& seg_nradl, std::vector<float>& cumLen, bool fwd, bool momDepConst, int pid) const;
+    double mcsLikelihood(double p, double theta0x, const std::vector<float>& dthetaij, const std::vector<float>& seg_nradl, const std::vector<float>& cumLen, bool fwd, bool momDepConst, int pid) const;
     //
     struct ScanResult {
       public:
@@ -127,7 +157,7 @@ namespace trkf::sbn {
         double p, pUnc, logL;
     };
     //
-    const ScanResult doLikelihoodScan(std::vector<float>& dtheta, std::vector<float>& seg_nradlengths, std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const;
+    const ScanResult doLikelihoodScan(const std::vector<float>& dtheta, const std::vector<float>& seg_nradlengths, const std::vector<float>& cumLen, bool fwdFit, bool momDepConst, int pid) const;
     //
     inline double MomentumDependentConstant(const double p) const {
       //these are from https://arxiv.org/abs/1703.06187
@@ -148,6 +178,8 @@ namespace trkf::sbn {
     double GetE(const double initial_E, const double length_travelled, const double mass) const;
     //
   private:
+    void buildELossTables();
+    //
     int    pIdHyp_;
     int    minNSegs_;
     double segLen_;
@@ -158,6 +190,9 @@ namespace trkf::sbn {
     double pMax_;
     double pStep_;
     double angResol_;
+    int    scanCoarseStride_;
+    std::vector<double> pScan_;
+    std::vector<EnergyLossTable> eLossTables_;
   };
 }
 
@@ -75,15 +75,23 @@ void sbn::MCSFitAllPID::produce(art::Event& e)
   std::vector<art::Ptr<recob::Track>> tracks;
   art::fill_ptr_vector(tracks, track_handle);
 
+  // The segmentation does not depend on the PID, so do it once per track
+  std::vector<art::Ptr<recob::Track>> fit_tracks;
+  std::vector<trkf::sbn::TrajectoryMCSFitter::Segmentation> segmentations;
+  for (const art::Ptr<recob::Track> track: tracks) {
+    if (fMinTrackLength > 0. && track->Length() < fMinTrackLength) continue;
+
+    fit_tracks.push_back(track);
+    segmentations.push_back(fMCSCalculator.segmentTrajectory(*track));
+  }
+
   for (unsigned i = 0; i < PIDs.size(); i++) {
     std::unique_ptr<std::vector<recob::MCSFitResult>> mcscol(new std::vector<recob::MCSFitResult>);
     std::unique_ptr<art::Assns<recob::Track, recob::MCSFitResult>> assn(new art::Assns<recob::Track, recob::MCSFitResult>);
 
-    for (const art::Ptr<recob::Track> track: tracks) {
-      if (fMinTrackLength > 0. && track->Length() < fMinTrackLength) continue;
-
-      mcscol->push_back(fMCSCalculator.fitMcs(*track, PIDs[i]));        
-      util::CreateAssn(*this, e, *mcscol, track, *assn, names[i]);
+    for (unsigned i_trk = 0; i_trk < fit_tracks.size(); i_trk++) {
+      mcscol->push_back(fMCSCalculator.fitMcs(segmentations[i_trk], PIDs[i]));        
+      util::CreateAssn(*this, e, *mcscol, fit_tracks[i_trk], *assn, names[i]);
     }
 
     e.put(std::move(mcscol), names[i]);
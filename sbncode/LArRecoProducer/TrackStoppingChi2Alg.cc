@@ -1,8 +1,96 @@
 #include "sbncode/LArRecoProducer/TrackStoppingChi2Alg.h"
 
-#include "TF1.h"
-#include "TGraph.h"
+#include <cmath>
+
+namespace {
+
+  // Least-squares fit of a constant, as TGraph::Fit("pol0") with unit errors:
+  // the mean, and the sum of squared residuals about it
+  void FitPol0(const std::vector<float> &y, double &p0, double &chi2)
+  {
+    double sum(0.);
+    for (const float v : y)
+      sum += v;
+    p0 = sum / y.size();
+
+    chi2 = 0.;
+    for (const float v : y)
+      chi2 += (v - p0) * (v - p0);
+  }
 
+  double ExpoChi2(const std::vector<float> &x, const std::vector<float> &y, const double a, const double b)
+  {
+    double chi2(0.);
+    for (size_t i = 0; i < x.size(); i++) {
+      const double r(y[i] - std::exp(a + b * x[i]));
+      chi2 += r * r;
+    }
+    return chi2;
+  }
+
+  // Least-squares fit of exp(a + b*x), as TGraph::Fit("expo") with unit errors.
+  // Starts from the straight-line fit to log(y), as ROOT does, then minimises
+  // the chi2 of the exponential itself with Levenberg-Marquardt steps.
+  // Returns false if there are not enough positive points to start from.
+  bool FitExpo(const std::vector<float> &x, const std::vector<float> &y, double &chi2)
+  {
+    double n(0.), sx(0.), sy(0.), sxx(0.), sxy(0.);
+    for (size_t i = 0; i < x.size(); i++) {
+      if (y[i] <= 0.f)
+        continue;
+      const double ly(std::log(y[i]));
+      n += 1.;
+      sx += x[i];
+      sy += ly;
+      sxx += x[i] * x[i];
+      sxy += x[i] * ly;
+    }
+    const double det(n * sxx - sx * sx);
+    if (n < 2. || det == 0.)
+      return false;
+
+    double b((n * sxy - sx * sy) / det);
+    double a((sy - b * sx) / n);
+    chi2 = ExpoChi2(x, y, a, b);
+
+    double lambda(1.e-3);
+    for (unsigned iter = 0; iter < 200 && lambda < 1.e12; iter++) {
+      // normal equations of the linearised problem
+      double jaa(0.), jab(0.), jbb(0.), ga(0.), gb(0.);
+      for (size_t i = 0; i < x.size(); i++) {
+        const double f(std::exp(a + b * x[i]));
+        const double r(y[i] - f);
+        jaa += f * f;
+        jab += x[i] * f * f;
+        jbb += x[i] * x[i] * f * f;
+        ga += r * f;
+        gb += r * x[i] * f;
+      }
+
+      const double daa(jaa * (1. + lambda)), dbb(jbb * (1. + lambda));
+      const double d(daa * dbb - jab * jab);
+      if (d == 0.)
+        break;
+      const double na(a + (dbb * ga - jab * gb) / d);
+      const double nb(b + (daa * gb - jab * ga) / d);
+
+      const double newChi2(ExpoChi2(x, y, na, nb));
+      if (std::isfinite(newChi2) && newChi2 <= chi2) {
+        const bool converged(chi2 - newChi2 <= 1.e-12 * chi2);
+        a = na;
+        b = nb;
+        chi2 = newChi2;
+        lambda *= 0.1;
+        if (converged)
+          break;
+      }
+      else {
+        lambda *= 10.;
+      }
+    }
+    return true;
+  }
+}
 
 sbn::TrackStoppingChi2Alg::TrackStoppingChi2Alg(fhicl::ParameterSet const& p) :
   fFitRange(p.get<float>("FitRange"))
@@ -16,21 +104,18 @@ sbn::StoppingChi2Fit sbn::TrackStoppingChi2Alg::RunFit(const std::vector<float>
   if (dEdxVec.size() != resRangeVec.size())
     throw cet::exception("TrackStoppingChi2Alg") << "dEdx and Res Range do not have same length: " << dEdxVec.size() << " and " << resRangeVec.size() << std::endl;
 
-  if (dEdxVec.size() < fMinHits)
+  if (dEdxVec.size() < fMinHits || dEdxVec.empty())
     return StoppingChi2Fit();
 
-  const auto graph(std::make_unique<TGraph>(dEdxVec.size(), &resRangeVec[0], &dEdxVec[0]));
-
   // Try and fit a flat polynomial
-  graph->Fit("pol0", "Q");
-  const TF1* polFit = graph->GetFunction("pol0");
-  const float pol0Chi2(polFit ? polFit->GetChisquare() : -5.f);
-  const float pol0Fit(polFit ? polFit->GetParameter(0) : -5.f);
+  double pol0Par(0.), pol0Res(0.);
+  FitPol0(dEdxVec, pol0Par, pol0Res);
+  const float pol0Chi2(pol0Res);
+  const float pol0Fit(pol0Par);
 
   // Try to fit an exponential
-  graph->Fit("expo", "Q");
-  const TF1* expFit = graph->GetFunction("expo");
-  const float expChi2(expFit ? expFit->GetChisquare() : -5.f);
+  double expRes(0.);
+  const float expChi2(FitExpo(resRangeVec, dEdxVec, expRes) ? expRes : -5.f);
 
   return StoppingChi2Fit(pol0Chi2, expChi2, pol0Fit);
 }
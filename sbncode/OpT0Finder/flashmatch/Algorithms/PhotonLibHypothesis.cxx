@@ -4,6 +4,7 @@
 #include "PhotonLibHypothesis.h"
 
 #include <omp.h>
+#include <mutex>
 #define NUM_THREADS 4
 
 #ifndef USING_LARSOFT
@@ -15,6 +16,11 @@ namespace flashmatch {
 
   static PhotonLibHypothesisFactory __global_PhotonLibHypothesisFactory__;
 
+  #if USING_LARSOFT == 1
+  /// Serializes the visibility service calls of concurrent instances
+  static std::mutex __visibility_mutex__;
+  #endif
+
   PhotonLibHypothesis::PhotonLibHypothesis(const std::string name)
     : BaseFlashHypothesis(name)
     , _vis(art::ServiceHandle<phot::PhotonVisibilityService const>().get())
@@ -47,6 +53,36 @@ namespace flashmatch {
     for (size_t i = 0; i < DetectorSpecs::GetME().NOpDets(); i++) {
       _channel_mask[i] = i;
     }
+    BuildChannelFlags();
+  }
+
+  void PhotonLibHypothesis::SetChannelMask(std::vector<int> ch_mask)
+  {
+    BaseFlashHypothesis::SetChannelMask(ch_mask);
+    BuildChannelFlags();
+  }
+
+  void PhotonLibHypothesis::SetUncoatedPMTs(std::vector<int> ch_uncoated)
+  {
+    BaseFlashHypothesis::SetUncoatedPMTs(ch_uncoated);
+    BuildChannelFlags();
+  }
+
+  void PhotonLibHypothesis::BuildChannelFlags()
+  {
+    // Resolve the channel mask and the uncoated PMT list once, so that
+    // the hypothesis kernels do not search them for every point
+    size_t n_pmt = DetectorSpecs::GetME().NOpDets();
+
+    _use_channel_v.assign(n_pmt, 0);
+    for (auto const& ch : _channel_mask) {
+      if (ch >= 0 && (size_t)ch < n_pmt) _use_channel_v[ch] = 1;
+    }
+
+    _use_direct_v = _use_channel_v;
+    for (auto const& ch : _uncoated_pmt_list) {
+      if (ch >= 0 && (size_t)ch < n_pmt) _use_direct_v[ch] = 0;
+    }
   }
 
   //
@@ -133,46 +169,64 @@ namespace flashmatch {
 
   void PhotonLibHypothesis::FillEstimateLibrary(const QCluster_t& trk, Flash_t &flash) const
   {
-
-    static double xyz[3] = {0.};
+    // Point-outer kernel: the full direct and reflected visibility rows of
+    // each point are fetched once, and all PMTs are accumulated in a
+    // contiguous loop over the per-channel flags.
+    // Each PMT still receives the same terms, computed with the same
+    // expression and summed in the same point order as a PMT-outer loop,
+    // so the result is bitwise identical to evaluating pairs one by one.
 
     size_t n_pmt = DetectorSpecs::GetME().NOpDets();
 
-    for ( size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
-
-      if (std::find(_channel_mask.begin(), _channel_mask.end(), ipmt) == _channel_mask.end()) {
-        continue;
+    bool const use_refl = _vis->StoreReflected();
+
+    // When it interpolates, the service returns a view of a buffer shared by
+    // all its callers: copy each row, under a lock if other instances run
+    _direct_vis_v.resize(n_pmt);
+    _refl_vis_v.resize(n_pmt);
+    std::unique_lock<std::mutex> lock(__visibility_mutex__, std::defer_lock);
+    auto fetch = [&](geo::Point_t const& xyz, bool reflected, std::vector<float>& vis_v) {
+      if (_concurrent) lock.lock();
+      auto const vis = _vis->GetAllVisibilities(xyz, reflected);
+      if (vis) {
+        for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) vis_v[ipmt] = vis[ipmt];
       }
+      if (_concurrent) lock.unlock();
+      return bool(vis);
+    };
+    float const* direct_vis = _direct_vis_v.data();
+    float const* refl_vis = _refl_vis_v.data();
+
+    double* pe = flash.pe_v.data();
+    double const* qe = _qe_v.data();
+    char const* use_channel = _use_channel_v.data();
+    char const* use_direct = _use_direct_v.data();
+
+    for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
+      auto const& pt = trk[ipt];
 
-      bool is_uncoated = false;
-      if (std::find(_uncoated_pmt_list.begin(), _uncoated_pmt_list.end(), ipmt) != _uncoated_pmt_list.end()) {
-        is_uncoated = true;
-      }
+      double q = pt.q;
 
-      for (size_t ipt = 0; ipt < trk.size(); ++ipt) {
-        auto const& pt = trk[ipt];
+      geo::Point_t const xyz = {pt.x, pt.y, pt.z};
 
-        double q = pt.q;
+      // The service maps the point into the library (and interpolates if
+      // configured to); points outside the library have no visibilities
+      if (!fetch(xyz, false, _direct_vis_v)) continue;
 
-        xyz[0] = pt.x;
-        xyz[1] = pt.y;
-        xyz[2] = pt.z;
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
+        // Direct light (uncoated PMTs don't see it)
+        double q_direct = use_direct[ipmt] ? q * direct_vis[ipmt] * _global_qe / qe[ipmt] : 0.;
+        pe[ipmt] += use_channel[ipmt] ? q_direct : 0.;
+      }
 
-        double q_direct = 0, q_refl = 0;
+      if (!use_refl) continue;
 
-        // Direct light
-        if (is_uncoated) {
-          q_direct = 0;
-        } else {
-          q_direct = q * _vis->GetVisibility(xyz, ipmt) * _global_qe / _qe_v[ipmt];
-        }
-        // std::cout << "PMT : " << ipmt << " [x,y,z] -> [q] : [" << pt.x << ", " << pt.y << ", " << pt.z << "] -> [" << q << "]" << std::endl;
+      if (!fetch(xyz, true, _refl_vis_v)) continue;
 
+      for (size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
         // Reflected light
-        q_refl = q * _vis->GetVisibility(xyz, ipmt, true) * _global_qe_refl / _qe_v[ipmt];
-
-        flash.pe_v[ipmt] += q_direct;
-        flash.pe_v[ipmt] += q_refl;
+        double q_refl = q * refl_vis[ipmt] * _global_qe_refl / qe[ipmt];
+        pe[ipmt] += use_channel[ipmt] ? q_refl : 0.;
       }
     }
     return;
@@ -204,9 +258,10 @@ namespace flashmatch {
     for (auto& v : flash.pe_v     ) v = 0;
     for (auto& v : flash.pe_err_v ) v = 0;
 
-    auto det = DetectorSpecs::GetME();
+    auto const& det = DetectorSpecs::GetME();
 
-    auto const& lib_data = DetectorSpecs::GetME().GetPhotonLibraryData();
+    // the library is loaded lazily: trigger it here, not from within the threads
+    det.GetPhotonLibraryEntries(0);
 
     //start = high_resolution_clock::now();
     #pragma omp parallel
@@ -217,7 +272,7 @@ namespace flashmatch {
       size_t start_pt = num_pts * thread_id;
       if(thread_id+1 == num_threads) num_pts += (trk.size() % num_threads);
 
-      auto const& vox_def = DetectorSpecs::GetME().GetVoxelDef();
+      auto const& vox_def = det.GetVoxelDef();
       // auto s = vox_def.GetVoxelSize();
       // auto s1 = vox_def.GetRegionLowerCorner();
       // auto s2 = vox_def.GetRegionUpperCorner();
@@ -230,7 +285,7 @@ namespace flashmatch {
         auto const& pt = trk[ipt];
         vox_id = vox_def.GetVoxelID(pt.x,pt.y,pt.z);
         if (vox_id < 0) continue;
-        auto const& vis_pmt = lib_data[vox_id];
+        auto const vis_pmt = det.GetPhotonLibraryEntries(vox_id);
         for ( size_t ipmt = 0; ipmt < n_pmt; ++ipmt) {
           local_pe_v[ipmt] += pt.q * vis_pmt[ipmt];
         }
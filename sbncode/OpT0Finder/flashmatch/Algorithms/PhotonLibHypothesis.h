@@ -52,7 +52,16 @@ namespace flashmatch {
 
     void FillEstimate(const QCluster_t&, Flash_t&) const;
 
+    /// Sets the channels to use, and rebuilds the per-channel flags
+    void SetChannelMask(std::vector<int> ch_mask) override;
+
+    /// Sets the channels sensitive to visible light, and rebuilds the per-channel flags
+    void SetUncoatedPMTs(std::vector<int> ch_uncoated) override;
+
   private:
+    /// Fills _use_channel_v and _use_direct_v from the channel mask and uncoated list
+    void BuildChannelFlags();
+
     /// Fills the estimate using the semi analytical approach (SBND)
     void FillEstimateSemiAnalytical(const QCluster_t&, Flash_t &) const;
 
@@ -68,8 +77,12 @@ namespace flashmatch {
     double _sigma_qe;              ///< Sigma for Gaussian centered on Global QE
     std::vector<double> _qe_v;     ///< PMT-wise relative QE
     bool _use_semi_analytical;     ///< If the semi-analytical approach should be used
+    std::vector<char> _use_channel_v; ///< PMT-wise flag: channel is in the channel mask
+    std::vector<char> _use_direct_v;  ///< PMT-wise flag: channel is in the mask and sees direct light
     #if USING_LARSOFT == 1
     phot::PhotonVisibilityService const* const _vis;
+    mutable std::vector<float> _direct_vis_v; ///< Direct visibility row of the current point
+    mutable std::vector<float> _refl_vis_v;   ///< Reflected visibility row of the current point
     #endif
   };
 
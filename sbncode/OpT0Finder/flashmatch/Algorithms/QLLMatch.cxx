@@ -9,16 +9,30 @@ namespace flashmatch {
   static QLLMatchFactory __global_QLLMatchFactory__;
 
   QLLMatch *QLLMatch::_me = nullptr;
+  thread_local QLLMatch *QLLMatch::_active = nullptr;
 
   void MIN_vtx_qll(Int_t &, Double_t *, Double_t &, Double_t *, Int_t);
 
   QLLMatch::QLLMatch(const std::string name)
-    : BaseFlashMatch(name), _mode(kChi2), _record(false), _normalize(false), _minuit_ptr(nullptr)
+    : BaseFlashMatch(name), _mode(kChi2), _record(false), _normalize(false), _minuit_ptr(new TMinuit(4))
+    , _minimizer(kMinuit), _brent_tolerance(0.5), _brent_max_iterations(100), _newton_refine(false)
+    , _hypo_cache_step(0.), _hypo_cache_use(false), _hypo_cache_xmin(0.)
+    , _hypo_cache_nfill(0), _hypo_cache_ninterp(0)
   { _current_llhd = _current_chi2 = -1.0; }
 
   QLLMatch::QLLMatch()
   { throw OpT0FinderException("Use QLLMatch::GetME() to obtain singleton pointer!"); }
 
+  BaseFlashMatch* QLLMatch::Clone() const {
+    // The copy owns its own track, hypothesis, measurement and minimizer
+    // state; TMinuit is not thread safe to construct, so it is made here,
+    // before any concurrent fit, and reused by every fit of the copy
+    auto ptr = new QLLMatch(*this);
+    ptr->_minuit_ptr = new TMinuit(4);
+    ptr->ResetHypothesisCache();
+    return ptr;
+  }
+
   void QLLMatch::_Configure_(const Config_t &pset) {
     _record = pset.get<bool>("RecordHistory");
     _normalize = pset.get<bool>("NormalizeHypothesis");
@@ -26,6 +40,18 @@ namespace flashmatch {
     _pe_observation_threshold = pset.get<double>("PEObservationThreshold", 0.0);
     _pe_hypothesis_threshold  = pset.get<double>("PEHypothesisThreshold", 0.0);
     _migrad_tolerance         = pset.get<double>("MIGRADTolerance", 0.1);
+    _hypo_cache_step          = pset.get<double>("HypothesisCacheStep", 0.);
+
+    auto const minimizer      = pset.get<std::string>("Minimizer", "Minuit");
+    if (minimizer == "Minuit") _minimizer = kMinuit;
+    else if (minimizer == "Brent") _minimizer = kBrent;
+    else {
+      FLASH_CRITICAL() << "Unknown Minimizer " << minimizer << " (use Minuit or Brent)" << std::endl;
+      throw OpT0FinderException();
+    }
+    _brent_tolerance          = pset.get<double>("BrentTolerance", 0.5);
+    _brent_max_iterations     = pset.get<int>("BrentMaxIterations", 100);
+    _newton_refine            = pset.get<bool>("NewtonRefine", false);
 
     this->set_verbosity((msg::Level_t)(pset.get<unsigned int>("Verbosity", 3)));
 
@@ -59,6 +85,7 @@ namespace flashmatch {
       _vol_xmin = bbox.Min()[0];
     }
 
+    ResetHypothesisCache();
   }
 
   void QLLMatch::SetTPCCryo(int tpc, int cryo) {
@@ -68,6 +95,19 @@ namespace flashmatch {
     auto const& bbox = DetectorSpecs::GetME().ActiveVolume(_tpc, _cryo);
     _vol_xmax = bbox.Max()[0];
     _vol_xmin = bbox.Min()[0];
+
+    ResetHypothesisCache();
+  }
+
+  void QLLMatch::ResetHypothesisCache() {
+    _hypo_cache_v.clear();
+    _hypo_cache_trk.clear();
+    _hypo_cache_nfill = _hypo_cache_ninterp = 0;
+    if (_hypo_cache_step <= 0.) return;
+
+    _hypo_cache_xmin = _vol_xmin;
+    size_t nodes = (size_t)(std::ceil((_vol_xmax - _vol_xmin) / _hypo_cache_step)) + 1;
+    _hypo_cache_v.resize(nodes);
   }
 
 
@@ -89,6 +129,22 @@ namespace flashmatch {
     }
     for (auto &pt : _raw_trk) pt.x -= min_x;
 
+    // The hypothesis only depends on the TPC object and on the x offset,
+    // so cached grid nodes stay valid while the same object is matched
+    // against other flashes
+    if (_hypo_cache_step > 0.) {
+      bool same_trk = (_raw_trk.size() == _hypo_cache_trk.size());
+      for (size_t i = 0; same_trk && i < _raw_trk.size(); ++i) {
+        auto const &a = _raw_trk[i];
+        auto const &b = _hypo_cache_trk[i];
+        same_trk = (a.x == b.x && a.y == b.y && a.z == b.z && a.q == b.q);
+      }
+      if (!same_trk) {
+        ResetHypothesisCache();
+        _hypo_cache_trk = _raw_trk;
+      }
+    }
+
     auto res1 = PESpectrumMatch(pt_v,flash,true);
     auto res2 = PESpectrumMatch(pt_v,flash,false);
     FLASH_INFO() << "Using   mid-x-init ... maximized 1/param Score=" << res1.score << " @ X=" << res1.tpc_point.x << " [cm]" << std::endl;
@@ -106,6 +162,9 @@ namespace flashmatch {
     }
     */
     FLASH_INFO() << "Time spent constructing hypotheses: " << _construct_hypo_time << " ns." << std::endl;
+    if (_hypo_cache_step > 0.)
+      FLASH_INFO() << "Hypothesis cache: " << _hypo_cache_nfill << " grid nodes computed, "
+                   << _hypo_cache_ninterp << " interpolated hypotheses for this TPC object" << std::endl;
     return res;
   }
 
@@ -243,35 +302,8 @@ namespace flashmatch {
       throw OpT0FinderException("Hypothesis vector length != PMT count");
     }
 
-    for (auto &v : _hypothesis.pe_v) v = 0;
-
-    // Apply xoffset
-    _var_trk.resize(_raw_trk.size());
-    for (size_t pt_index = 0; pt_index < _raw_trk.size(); ++pt_index) {
-      //std::cout << "x point : " << _raw_trk[pt_index].x << "\t offset : " << xoffset << std::endl;
-      _var_trk[pt_index].x = _raw_trk[pt_index].x + xoffset;
-      _var_trk[pt_index].y = _raw_trk[pt_index].y;
-      _var_trk[pt_index].z = _raw_trk[pt_index].z;
-      _var_trk[pt_index].q = _raw_trk[pt_index].q;
-      if (_raw_trk[pt_index].q > 1e20) std::cout << "[QLLMatch::ChargeHypothesis] n_original_photons " << _raw_trk[pt_index].q << std::endl;
-    }
-    //auto end = high_resolution_clock::now();
-    //auto duration = duration_cast<microseconds>(end - start);
-    //std::cout << "Duration ChargeHypothesis 1 = " << duration.count() << "us" << std::endl;
-
-
-    //start = high_resolution_clock::now();
-    // for ( size_t ipt = 0; ipt < trk.size(); ++ipt) {
-    //   double n_original_photons = pt.q;
-    //   if (n_original_photons > 1e20) std::cout << "n_original_photons " << n_original_photons << std::endl;
-    // }
-    FillEstimate(_var_trk, _hypothesis);
-    // std::cout << "hypo pe: ";
-    // for (auto &v : _hypothesis.pe_v) std::cout << v << " ";
-    //   std::cout << std::endl;;
-    //end = high_resolution_clock::now();
-    //duration = duration_cast<microseconds>(end - start);
-    //std::cout << "Duration ChargeHypothesis 2 = " << duration.count() << "us" << std::endl;
+    if (!(_hypo_cache_use && InterpolateHypothesis(xoffset, _hypothesis)))
+      FillHypothesis(xoffset, _hypothesis);
 
     //start = high_resolution_clock::now();
     if (_normalize) {
@@ -288,6 +320,50 @@ namespace flashmatch {
     return _hypothesis;
   }
 
+  void QLLMatch::FillHypothesis(const double xoffset, Flash_t &hypo) {
+
+    for (auto &v : hypo.pe_v) v = 0;
+
+    // Apply xoffset
+    _var_trk.resize(_raw_trk.size());
+    for (size_t pt_index = 0; pt_index < _raw_trk.size(); ++pt_index) {
+      _var_trk[pt_index].x = _raw_trk[pt_index].x + xoffset;
+      _var_trk[pt_index].y = _raw_trk[pt_index].y;
+      _var_trk[pt_index].z = _raw_trk[pt_index].z;
+      _var_trk[pt_index].q = _raw_trk[pt_index].q;
+      if (_raw_trk[pt_index].q > 1e20) std::cout << "[QLLMatch::ChargeHypothesis] n_original_photons " << _raw_trk[pt_index].q << std::endl;
+    }
+
+    FillEstimate(_var_trk, hypo);
+  }
+
+  bool QLLMatch::InterpolateHypothesis(const double xoffset, Flash_t &hypo) {
+
+    double const u = (xoffset - _hypo_cache_xmin) / _hypo_cache_step;
+    if (u < 0.) return false;
+    size_t const node = (size_t)u;
+    if (node + 1 >= _hypo_cache_v.size()) return false;
+
+    // Compute the bracketing grid nodes the first time they are needed
+    for (size_t inode = node; inode <= node + 1; ++inode) {
+      if (!_hypo_cache_v[inode].empty()) continue;
+      Flash_t node_hypo;
+      node_hypo.pe_v.resize(hypo.pe_v.size(), 0.);
+      FillHypothesis(_hypo_cache_xmin + inode * _hypo_cache_step, node_hypo);
+      _hypo_cache_v[inode] = std::move(node_hypo.pe_v);
+      ++_hypo_cache_nfill;
+    }
+
+    double const frac = u - node;
+    auto const &lo = _hypo_cache_v[node];
+    auto const &hi = _hypo_cache_v[node + 1];
+    for (size_t pmt_index = 0; pmt_index < hypo.pe_v.size(); ++pmt_index)
+      hypo.pe_v[pmt_index] = (1. - frac) * lo[pmt_index] + frac * hi[pmt_index];
+
+    ++_hypo_cache_ninterp;
+    return true;
+  }
+
   const Flash_t &QLLMatch::Measurement() const { return _measurement; }
 
   double QLLMatch::QLL(const Flash_t &hypothesis,
@@ -383,29 +459,141 @@ namespace flashmatch {
     //std::cout << "minuit Xval?? : " << *Xval << std::endl;
 
     //auto start = high_resolution_clock::now();
-    auto const &hypothesis = QLLMatch::GetME()->ChargeHypothesis(*Xval);
+    auto const &hypothesis = QLLMatch::Active()->ChargeHypothesis(*Xval);
     //auto end = high_resolution_clock::now();
     //auto duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration ChargeHypothesis = " << duration.count() << "us" << std::endl;
 
     //start = high_resolution_clock::now();
-    auto const &measurement = QLLMatch::GetME()->Measurement();
+    auto const &measurement = QLLMatch::Active()->Measurement();
     //end = high_resolution_clock::now();
     //duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration Measurement = " << duration.count() << "us" << std::endl;
 
     //start = high_resolution_clock::now();
-    Fval = QLLMatch::GetME()->QLL(hypothesis, measurement);
+    Fval = QLLMatch::Active()->QLL(hypothesis, measurement);
     //end = high_resolution_clock::now();
     //duration = duration_cast<microseconds>(end - start);
     //std::cout << "Duration QLL = " << duration.count() << "us" << std::endl;
 
-    QLLMatch::GetME()->Record(Xval[0]);
-    QLLMatch::GetME()->OneStep();
+    QLLMatch::Active()->Record(Xval[0]);
+    QLLMatch::Active()->OneStep();
 
     return;
   }
 
+  double QLLMatch::EvaluateQLL(const double xoffset) {
+    double const qll = QLL(ChargeHypothesis(xoffset), _measurement);
+    Record(xoffset);
+    OneStep();
+    return qll;
+  }
+
+  double QLLMatch::CallBrent(const double x0, const double xmin, const double xmax) {
+
+    auto start = high_resolution_clock::now();
+
+    // Brent's method (parabolic interpolation safeguarded by golden section)
+    // on the bracket [xmin, xmax], with the first point at the initial guess
+    static const double kGolden = 0.3819660;
+
+    double a = xmin, b = xmax;
+    double x = std::min(std::max(x0, a), b);
+    double w = x, v = x;
+    double fx = 0., fw = 0., fv = 0.;
+    double d = 0., e = 0.;
+
+    _hypo_cache_use = (_hypo_cache_step > 0.);
+    fx = fw = fv = EvaluateQLL(x);
+
+    for (int iter = 0; iter < _brent_max_iterations; ++iter) {
+      double const xm = 0.5 * (a + b);
+      double const tol1 = _brent_tolerance + 1.e-10 * std::fabs(x);
+      double const tol2 = 2. * tol1;
+      if (std::fabs(x - xm) <= (tol2 - 0.5 * (b - a))) break;
+
+      bool golden = true;
+      if (std::fabs(e) > tol1) {
+        // Trial parabolic fit through x, w, v
+        double r = (x - w) * (fx - fv);
+        double q = (x - v) * (fx - fw);
+        double p = (x - v) * q - (x - w) * r;
+        q = 2. * (q - r);
+        if (q > 0.) p = -p;
+        q = std::fabs(q);
+        double const etemp = e;
+        e = d;
+        if (std::fabs(p) < std::fabs(0.5 * q * etemp) && p > q * (a - x) && p < q * (b - x)) {
+          d = p / q;
+          double const u = x + d;
+          if (u - a < tol2 || b - u < tol2) d = std::copysign(tol1, xm - x);
+          golden = false;
+        }
+      }
+      if (golden) {
+        e = (x >= xm ? a - x : b - x);
+        d = kGolden * e;
+      }
+
+      double const u = (std::fabs(d) >= tol1 ? x + d : x + std::copysign(tol1, d));
+      double const fu = EvaluateQLL(u);
+
+      if (fu <= fx) {
+        if (u >= x) a = x; else b = x;
+        v = w; fv = fw;
+        w = x; fw = fx;
+        x = u; fx = fu;
+      } else {
+        if (u < x) a = u; else b = u;
+        if (fu <= fw || w == x) {
+          v = w; fv = fw;
+          w = u; fw = fu;
+        } else if (fu <= fv || v == x || v == w) {
+          v = u; fv = fu;
+        }
+      }
+    }
+
+    // Curvature from a central difference around the minimum gives the
+    // parabolic error (as Minuit's, with UP=1) and an optional Newton step
+    double x_err = (xmax - xmin) / 2.;
+    double const h = std::min(10. * _brent_tolerance, std::min(x - xmin, xmax - x));
+    if (h > _brent_tolerance) {
+      double const f_lo = EvaluateQLL(x - h);
+      double const f_hi = EvaluateQLL(x + h);
+      double const grad = (f_hi - f_lo) / (2. * h);
+      double const curv = (f_hi - 2. * fx + f_lo) / (h * h);
+      if (curv > 0.) {
+        x_err = std::sqrt(2. / curv);
+        if (_newton_refine) {
+          double const u = std::min(std::max(x - grad / curv, xmin), xmax);
+          double const fu = EvaluateQLL(u);
+          if (fu < fx) { x = u; fx = fu; }
+        }
+      }
+    }
+    _hypo_cache_use = false;
+
+    _converged = true;
+
+    // Exact evaluation at the minimum, leaving _hypothesis filled for it
+    double const fmin = EvaluateQLL(x);
+    if (_hypo_cache_step > 0.)
+      FLASH_INFO() << "Hypothesis cache: QLL at minimum interpolated " << fx
+                   << " exact " << fmin << std::endl;
+
+    _reco_x_offset = x;
+    _reco_x_offset_err = x_err;
+    _qll = fmin;
+
+    auto end = high_resolution_clock::now();
+    FLASH_INFO() << "Brent minimum x=" << x << " +/- " << x_err << " QLL=" << _qll
+                 << " in " << _num_steps << " steps, "
+                 << duration_cast<nanoseconds>(end - start).count() << " ns" << std::endl;
+
+    return _qll;
+  }
+
   double QLLMatch::CallMinuit(const QCluster_t &tpc, const Flash_t &pmt, const bool init_x0) {
 
     if (_measurement.pe_v.empty()) {
@@ -448,8 +636,6 @@ namespace flashmatch {
     _minimizer_record_x_v.clear();
     _num_steps = 0;
 
-    if (!_minuit_ptr) _minuit_ptr = new TMinuit(4);
-
     double reco_x = _vol_xmin + 10;
     if (!init_x0) {
       //reco_x = ((_vol_xmax - _vol_xmin) - (_raw_xmax_pt.x - _raw_xmin_pt.x)) / 2. + _vol_xmin;
@@ -462,6 +648,12 @@ namespace flashmatch {
     double xmin = _vol_xmin;
     double xmax = (_vol_xmax - _vol_xmin) - (_raw_xmax_pt.x - _raw_xmin_pt.x) + _vol_xmin;
 
+    if (_minimizer == kBrent) {
+      FLASH_INFO() << "Running Brent x: " << xmin << " => " << xmax
+		   << " ... initial state x=" << reco_x << std::endl;
+      return CallBrent(reco_x, xmin, xmax);
+    }
+
     FLASH_INFO() << "Running Minuit x: " << xmin << " => " << xmax
 		 << " ... initial state x=" <<reco_x <<" x_err=" << reco_x_err << std::endl;
     double MinFval;
@@ -469,7 +661,8 @@ namespace flashmatch {
     double arglist[4], Fmin, Fedm, Errdef;
     ierrflag = npari = nparx = istat = 0;
 
-    assert(this == QLLMatch::GetME());
+    // The Minuit callback has no user pointer: route it to this instance
+    _active = this;
 
     _minuit_ptr->SetPrintLevel(-1);
     arglist[0] = 2.0;  // set strategy level
@@ -485,7 +678,10 @@ namespace flashmatch {
 
     arglist[0] = 5000;  // maxcalls
     arglist[1] = _migrad_tolerance; // tolerance*1e-3 = convergence condition
+    // Minuit steps may use interpolated hypotheses; the minimum is re-evaluated exactly below
+    _hypo_cache_use = (_hypo_cache_step > 0.);
     _minuit_ptr->mnexcm("MIGRAD", arglist, 2, ierrflag);
+    _hypo_cache_use = false;
 
     _converged = true;
 
@@ -521,17 +717,22 @@ namespace flashmatch {
       }
     */
 
+    // With the hypothesis cache Minuit only saw interpolated hypotheses:
+    // keep the exact value at the minimum
+    if (_hypo_cache_step > 0.) {
+      FLASH_INFO() << "Hypothesis cache: QLL at minimum interpolated " << MinFval
+                   << " exact " << Fmin << std::endl;
+      MinFval = Fmin;
+    }
+
     // Transfer the minimization variables:
     _reco_x_offset = reco_x;
     _reco_x_offset_err = reco_x_err;
     _qll = MinFval;
 
-    // Clear:
+    // Clear, so the next fit starts from scratch with the same minimizer:
     _minuit_ptr->mnexcm("clear", arglist, 0, ierrflag);
 
-    if (_minuit_ptr) delete _minuit_ptr;
-    _minuit_ptr = 0;
-
     return _qll;
   }
 
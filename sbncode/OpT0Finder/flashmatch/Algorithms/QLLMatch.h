@@ -30,6 +30,7 @@
 #include "sbncode/OpT0Finder/flashmatch/Base/OpT0FinderException.h"
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <numeric>
@@ -52,6 +53,8 @@ namespace flashmatch {
 
     enum QLLMode_t { kChi2, kLLHD, kSimpleLLHD };
 
+    enum Minimizer_t { kMinuit, kBrent };
+
   private:
     /// Valid ctor hidden (singleton)
     QLLMatch(const std::string);
@@ -62,7 +65,7 @@ namespace flashmatch {
     QLLMatch();
 
     /// Default destructor
-    ~QLLMatch(){}
+    ~QLLMatch(){ delete _minuit_ptr; }
 
     /// Singleton shared instance getter
     static QLLMatch* GetME(std::string name="")
@@ -79,9 +82,18 @@ namespace flashmatch {
     /// Core function: execute matching
     FlashMatch_t Match(const QCluster_t&, const Flash_t&);
 
+    /// Independent copy (same configuration) for concurrent matching
+    BaseFlashMatch* Clone() const override;
+
+    /// Instance currently running the minimizer on this thread (used by the Minuit callback)
+    static QLLMatch* Active() { return _active; }
+
     const Flash_t& ChargeHypothesis(const double);
     const Flash_t& Measurement() const;
 
+    /// Drops all cached hypotheses (see HypothesisCacheStep)
+    void ResetHypothesisCache();
+
     double QLL(const flashmatch::Flash_t&,
                const flashmatch::Flash_t&);
 
@@ -98,10 +110,14 @@ namespace flashmatch {
         _num_steps = _num_steps + 1;
     }
 
+    /// Minimizes QLL over the x offset with the configured minimizer (Minuit or Brent)
     double CallMinuit(const QCluster_t& tpc,
 		      const Flash_t& pmt,
 		      const bool init_x0=true);
 
+    /// Hypothesis at xoffset, its QLL against the measurement, and step bookkeeping
+    double EvaluateQLL(const double xoffset);
+
     const std::vector<double>& HistoryLLHD() const { return _minimizer_record_llhd_v; }
     const std::vector<double>& HistoryChi2() const { return _minimizer_record_chi2_v; }
     const std::vector<double>& HistoryX()    const { return _minimizer_record_x_v;    }
@@ -118,7 +134,18 @@ namespace flashmatch {
 
     FlashMatch_t OnePMTMatch(const Flash_t &flash);
 
+    /// Brent minimization of QLL over [xmin, xmax] starting at x0 (alternative to MIGRAD)
+    double CallBrent(const double x0, const double xmin, const double xmax);
+
+    /// Fills hypo with the (unnormalized) hypothesis for _raw_trk shifted by xoffset
+    void FillHypothesis(const double xoffset, Flash_t& hypo);
+
+    /// Fills hypo by linear interpolation between the cached grid nodes around xoffset
+    /// (nodes are computed on first use); returns false if xoffset is outside the grid
+    bool InterpolateHypothesis(const double xoffset, Flash_t& hypo);
+
     static QLLMatch* _me;
+    static thread_local QLLMatch* _active;
 
     QLLMode_t _mode;   ///< Minimizer mode
     bool _record;      ///< Boolean switch to record minimizer history
@@ -150,6 +177,10 @@ namespace flashmatch {
 
     TMinuit* _minuit_ptr;
     double _migrad_tolerance;
+    Minimizer_t _minimizer;    ///< Minimizer used by CallMinuit
+    double _brent_tolerance;   ///< Brent convergence tolerance on x [cm]
+    int _brent_max_iterations; ///< Brent maximum number of iterations
+    bool _newton_refine;       ///< Try a finite-difference Newton step after Brent converges
     int _num_steps;
 
     double _recox_penalty_threshold;
@@ -165,6 +196,14 @@ namespace flashmatch {
 
     float _construct_hypo_time; ///< Keeps track of the total time spent constructing hypotheses
 
+    double _hypo_cache_step;  ///< x grid spacing [cm] of the hypothesis cache (<= 0: cache disabled)
+    bool   _hypo_cache_use;   ///< Whether ChargeHypothesis may interpolate from the cache right now
+    double _hypo_cache_xmin;  ///< x offset of the first cache grid node
+    std::vector<std::vector<double> > _hypo_cache_v; ///< Hypothesis per grid node (empty if not yet computed)
+    flashmatch::QCluster_t _hypo_cache_trk;          ///< TPC object (shifted to min-x = 0) the cache belongs to
+    size_t _hypo_cache_nfill;   ///< Number of grid nodes computed for the current TPC object
+    size_t _hypo_cache_ninterp; ///< Number of interpolated hypotheses for the current TPC object
+
   };
 
   /**
@@ -45,23 +45,27 @@ namespace flashmatch {
     virtual void FillEstimate(const QCluster_t&, Flash_t&) const = 0;
 
     /// Sets the channels to use
-    void SetChannelMask(std::vector<int> ch_mask) { _channel_mask = ch_mask; }
+    virtual void SetChannelMask(std::vector<int> ch_mask) { _channel_mask = ch_mask; }
 
     /// Sets the channels sensitive to visible light
-    void SetUncoatedPMTs(std::vector<int> ch_uncoated) { _uncoated_pmt_list = ch_uncoated; }
+    virtual void SetUncoatedPMTs(std::vector<int> ch_uncoated) { _uncoated_pmt_list = ch_uncoated; }
+
+    /// Set by the manager when several instances of the algorithm run at once
+    void SetConcurrent(bool concurrent) { _concurrent = concurrent; }
 
     #if USING_LARSOFT == 1
     /// Sets the semi analytical model
-    void SetSemiAnalyticalModel(std::unique_ptr<phot::SemiAnalyticalModel> model) { _semi_model = std::move(model); }
+    void SetSemiAnalyticalModel(std::shared_ptr<phot::SemiAnalyticalModel> model) { _semi_model = std::move(model); }
     #endif
 
   protected:
 
     std::vector<int> _channel_mask; ///< The list of channels to use
     std::vector<int> _uncoated_pmt_list; ///< A list of opdet sensitive to visible (reflected) light
+    bool _concurrent = false; ///< Other instances may call shared services at the same time
 
     #if USING_LARSOFT == 1
-    std::unique_ptr<phot::SemiAnalyticalModel> _semi_model;
+    std::shared_ptr<phot::SemiAnalyticalModel> _semi_model;
     #endif
 
   };
@@ -63,6 +63,13 @@ namespace flashmatch {
     /// Sets the TPC and Cryo numbers
     virtual void SetTPCCryo(int tpc, int cryo) = 0;
 
+    /**
+       Creates an independent instance with the same configuration and flash hypothesis, \n
+       which can run Match() concurrently with this one. Returns nullptr (the default) if \n
+       the algorithm does not support concurrent matching.
+    */
+    virtual BaseFlashMatch* Clone() const { return nullptr; }
+
   private:
 
     void SetFlashHypothesis(flashmatch::BaseFlashHypothesis*);
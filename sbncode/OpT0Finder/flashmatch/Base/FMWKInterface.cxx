@@ -62,8 +62,8 @@ namespace flashmatch{
   float DetectorSpecs::GetVisibility(double x, double y, double z, unsigned int opch) const
   { return phot::PhotonVisibilityService::GetME().GetVisibility(x,y,z,opch); }
 
-  const std::vector<std::vector<float > >& DetectorSpecs::GetPhotonLibraryData() const
-  { return phot::PhotonVisibilityService::GetME().GetLibraryData(); }
+  phot::VisibilitySpan DetectorSpecs::GetPhotonLibraryEntries(int vox_id) const
+  { return phot::PhotonVisibilityService::GetME().GetLibraryEntries(vox_id); }
 }
 
 #else
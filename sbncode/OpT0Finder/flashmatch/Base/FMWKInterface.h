@@ -12,6 +12,7 @@
 #include "FMWKTools/ConfigManager.h"
 #include "flashmatch/GeoAlgo/GeoAABox.h"
 #include "FMWKTools/PhotonVoxels.h"
+#include "FMWKTools/VisibilitySpan.h"
 namespace flashmatch {
   /// Configuration object
   using Config_t = flashmatch::PSet;
@@ -68,12 +69,12 @@ namespace flashmatch {
     /// Visibility Reflected
     float GetVisibilityReflected(double x, double y, double z, unsigned int opch) const;
 
-    /// Photon Library data access FIXME
-    const std::vector<std::vector<float > >& GetPhotonLibraryData() const;
-
     /// Voxel definition
     #if USING_LARSOFT == 0
     inline const sim::PhotonVoxelDef& GetVoxelDef() const { return _voxel_def; }
+
+    /// Photon Library visibilities of all opdets for one voxel (view into the library)
+    phot::VisibilitySpan GetPhotonLibraryEntries(int vox_id) const;
     #endif
 
   private:
@@ -14,13 +14,50 @@
 #include "TTree.h"
 #include "TKey.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace phot{
 
-  std::vector<float> PhotonLibrary::EmptyChannelsList; // used for invalid return value
+  namespace {
+
+    // Flat library file layout: FlatLibraryHeader, padding up to
+    // kFlatDataOffset, then NVoxels * NOpChannels floats (voxel-major).
+    // The data offset is page aligned so the float array can be used
+    // directly out of the mapping.
+    constexpr char     kFlatMagic[8]   = {'P','H','O','T','L','I','B','\0'};
+    constexpr uint32_t kFlatVersion    = 1;
+    constexpr uint64_t kFlatDataOffset = 4096;
+
+    struct FlatLibraryHeader {
+      char     magic[8];
+      uint32_t version;
+      uint32_t n_opchannels;
+      uint64_t n_voxels;
+      uint64_t data_offset;
+      double   lower[3];
+      double   upper[3];
+      int32_t  steps[3];
+      int32_t  pad;
+    };
+    static_assert(sizeof(FlatLibraryHeader) <= kFlatDataOffset, "flat library header too large");
+
+  }
 
   //------------------------------------------------------------
 
   PhotonLibrary::PhotonLibrary()
+    : fData(nullptr)
+    , fNOpChannels(0)
+    , fNVoxels(0)
+    , fMapAddr(nullptr)
+    , fMapSize(0)
   {
     fLookupTable.clear();
   }
@@ -30,11 +67,24 @@ namespace phot{
 
   PhotonLibrary::~PhotonLibrary()
   {
+    Unmap();
     fLookupTable.clear();
   }
 
   //------------------------------------------------------------
 
+  void PhotonLibrary::Unmap()
+  {
+    if(fMapAddr) {
+      munmap(fMapAddr, fMapSize);
+      fMapAddr = nullptr;
+      fMapSize = 0;
+      fData    = nullptr;
+    }
+  }
+
+  //------------------------------------------------------------
+
   void PhotonLibrary::StoreLibraryToFile(std::string LibraryFile)
   {
     std::cout << "Writing photon library to input file: " << LibraryFile.c_str()<<std::endl;
@@ -53,15 +103,15 @@ namespace phot{
     tt->Branch("Visibility", &Visibility, "Visibility/F");
 
 
-    for(size_t ivox=0; ivox!=fLookupTable.size(); ++ivox)
+    for(size_t ivox=0; ivox!=fNVoxels; ++ivox)
       {
-	for(size_t ichan=0; ichan!=fLookupTable.at(ivox).size(); ++ichan)
+	for(size_t ichan=0; ichan!=fNOpChannels; ++ichan)
 	  {
-	    if(fLookupTable[ivox].at(ichan) > 0)
+	    if(GetCount(ivox, ichan) > 0)
 	      {
 		Voxel      = ivox;
 		OpChannel  = ichan;
-		Visibility = fLookupTable[ivox][ichan];
+		Visibility = GetCount(ivox, ichan);
 		tt->Fill();
 	      }
 	  }
@@ -76,17 +126,14 @@ namespace phot{
 
   void PhotonLibrary::CreateEmptyLibrary( size_t NVoxels, size_t NOpChannels)
   {
+    Unmap();
     fLookupTable.clear();
 
     fNVoxels     = NVoxels;
     fNOpChannels = NOpChannels;
 
-    fLookupTable.resize(NVoxels);
-
-    for(size_t ivox=0; ivox!=NVoxels; ivox++)
-      {
-        fLookupTable[ivox].resize(NOpChannels,0);
-      }
+    fLookupTable.resize(NVoxels * NOpChannels, 0);
+    fData = fLookupTable.data();
   }
 
 
@@ -94,6 +141,7 @@ namespace phot{
 
   void PhotonLibrary::LoadLibraryFromFile(std::string LibraryFile, size_t NVoxels)
   {
+    Unmap();
     fLookupTable.clear();
 
     std::cout<< "Reading photon library from input file: " << LibraryFile.c_str()<<std::endl;
@@ -137,10 +185,13 @@ namespace phot{
 
 
     fNVoxels     = NVoxels;
-    fNOpChannels = 1;      // Minimum default, overwritten by library reading
 
+    // Set # of optical channels to 1 more than largest one seen, so that the
+    // flat table can be allocated once before reading the entries
+    fNOpChannels = std::max(1, (int)tt->GetMaximum("OpChannel") + 1);
 
-    fLookupTable.resize(NVoxels);
+    fLookupTable.assign(fNVoxels * fNOpChannels, 0);
+    fData = fLookupTable.data();
 
 
     size_t NEntries = tt->GetEntries();
@@ -148,23 +199,8 @@ namespace phot{
     for(size_t i=0; i!=NEntries; ++i) {
       tt->GetEntry(i);
 
-      // Set # of optical channels to 1 more than largest one seen
-      if (OpChannel >= (int)fNOpChannels)
-        fNOpChannels = OpChannel+1;
-
-      // Expand this voxel's vector if needed
-      if (fLookupTable[Voxel].size() < fNOpChannels)
-        fLookupTable[Voxel].resize(fNOpChannels, 0);
-
       // Set the visibility at this optical channel
-      fLookupTable[Voxel][OpChannel] = Visibility;
-    }
-
-    // Go through the table and fill in any missing 0's
-    for(size_t ivox=0; ivox!=NVoxels; ivox++)
-    {
-      if (fLookupTable[ivox].size() < fNOpChannels)
-	fLookupTable[ivox].resize(fNOpChannels,0);
+      fLookupTable[Voxel * fNOpChannels + OpChannel] = Visibility;
     }
 
 
@@ -181,34 +217,141 @@ namespace phot{
       }
   }
 
+  //------------------------------------------------------------
+
+  void PhotonLibrary::StoreLibraryToFlatFile(std::string LibraryFile, const sim::PhotonVoxelDef& VoxelDef) const
+  {
+    std::cout << "Writing flat photon library to file: " << LibraryFile.c_str()<<std::endl;
+
+    if((size_t)VoxelDef.GetNVoxels() != fNVoxels) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Voxel definition has " << VoxelDef.GetNVoxels()
+	       << " voxels but the library has " << fNVoxels << std::endl;
+      throw std::exception();
+    }
+
+    FlatLibraryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kFlatMagic, sizeof(kFlatMagic));
+    header.version      = kFlatVersion;
+    header.n_opchannels = fNOpChannels;
+    header.n_voxels     = fNVoxels;
+    header.data_offset  = kFlatDataOffset;
+    auto const lower = VoxelDef.GetRegionLowerCorner();
+    auto const upper = VoxelDef.GetRegionUpperCorner();
+    auto const steps = VoxelDef.GetSteps();
+    for(size_t i=0; i<3; ++i) {
+      header.lower[i] = lower[i];
+      header.upper[i] = upper[i];
+      header.steps[i] = (int32_t)steps[i];
+    }
+
+    std::ofstream fout(LibraryFile, std::ios::binary | std::ios::trunc);
+    if(!fout) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed to open for writing: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+    std::vector<char> padding(kFlatDataOffset - sizeof(header), 0);
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(padding.data(), padding.size());
+    fout.write(reinterpret_cast<const char*>(fData), fNVoxels * fNOpChannels * sizeof(float));
+    if(!fout) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed writing: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+  }
+
+  //------------------------------------------------------------
+
+  void PhotonLibrary::LoadLibraryFromFlatFile(std::string LibraryFile, const sim::PhotonVoxelDef& VoxelDef)
+  {
+    Unmap();
+    fLookupTable.clear();
+
+    std::cout<< "Mapping flat photon library from input file: " << LibraryFile.c_str()<<std::endl;
+
+    int fd = open(LibraryFile.c_str(), O_RDONLY);
+    if(fd < 0) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed to open a flat library file: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < kFlatDataOffset) {
+      close(fd);
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Flat library file too small: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    // Read-only shared mapping: the pages come straight from the page cache
+    // and are shared by every process mapping the same file
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED) {
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Failed to mmap: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    FlatLibraryHeader header;
+    std::memcpy(&header, addr, sizeof(header));
+
+    bool valid = (std::memcmp(header.magic, kFlatMagic, sizeof(kFlatMagic)) == 0 &&
+		  header.version == kFlatVersion &&
+		  header.data_offset + header.n_voxels * header.n_opchannels * sizeof(float) <= (size_t)st.st_size);
+    if(!valid) {
+      munmap(addr, st.st_size);
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Not a valid flat photon library: " << LibraryFile.c_str()<<std::endl;
+      throw std::exception();
+    }
+
+    sim::PhotonVoxelDef file_def(header.lower[0], header.upper[0], header.steps[0],
+				 header.lower[1], header.upper[1], header.steps[1],
+				 header.lower[2], header.upper[2], header.steps[2]);
+    if(file_def != VoxelDef) {
+      munmap(addr, st.st_size);
+      std::cerr<<"\033[95m<<"<<__FUNCTION__<<">>\033[00m " << "Voxel definition in " << LibraryFile.c_str()
+	       << " does not match the configured one" << std::endl;
+      throw std::exception();
+    }
+
+    fMapAddr     = addr;
+    fMapSize     = st.st_size;
+    fNVoxels     = header.n_voxels;
+    fNOpChannels = header.n_opchannels;
+    fData        = reinterpret_cast<const float*>(static_cast<const char*>(addr) + header.data_offset);
+
+    std::cout <<  fNVoxels << " voxels,  " << fNOpChannels<<" channels (mapped)" <<std::endl;
+  }
+
   //----------------------------------------------------
 
-  float PhotonLibrary::GetCount(size_t Voxel, size_t OpChannel)
+  float PhotonLibrary::GetCount(size_t Voxel, size_t OpChannel) const
   {
     //if(/*(Voxel<0)||*/(Voxel>=fNVoxels)||/*(OpChannel<0)||*/(OpChannel>=fNOpChannels))
     //  return 0;
     //else
-      return fLookupTable[Voxel][OpChannel]; 
+      return fData[Voxel * fNOpChannels + OpChannel];
   }
 
   //----------------------------------------------------
 
   void PhotonLibrary::SetCount(size_t Voxel, size_t OpChannel, float Count)
   {
-    if(/*(Voxel<0)||*/(Voxel>=fNVoxels))
+    if(IsMapped())
+      std::cerr <<"Error - attempting to set count in a read-only (mapped) library" <<std::endl;
+    else if(/*(Voxel<0)||*/(Voxel>=fNVoxels))
       std::cerr <<"Error - attempting to set count in voxel " << Voxel<<" which is out of range" <<std::endl;
     else
-      fLookupTable[Voxel].at(OpChannel) = Count;
+      fLookupTable.at(Voxel * fNOpChannels + OpChannel) = Count;
   }
 
   //----------------------------------------------------
 
-  const std::vector<float>* PhotonLibrary::GetCounts(size_t Voxel) const
+  VisibilitySpan PhotonLibrary::GetCounts(size_t Voxel) const
   {
     if(/*(Voxel<0)||*/(Voxel>=fNVoxels))
-      return EmptyList(); // FIXME!!! better to throw an exception!
+      return VisibilitySpan(); // FIXME!!! better to throw an exception!
     else
-      return &(fLookupTable[Voxel]);
+      return VisibilitySpan(fData + Voxel * fNOpChannels, fNOpChannels);
   }
 
 
@@ -1,6 +1,10 @@
 /*
   PhotonLibrary basically copied from
 
+  The visibilities are kept in a single voxel-major array, fNOpChannels floats
+  per voxel. The array either lives in memory (ROOT library, build jobs) or is
+  a read-only memory mapping of a flat library file (see StoreLibraryToFlatFile),
+  in which case all processes on a node share the same page-cache copy.
  */
 
 #ifndef PHOTONLIBRARY_H
@@ -8,42 +12,52 @@
 
 #include "TTree.h"
 #include "PhotonVoxels.h"
+#include "VisibilitySpan.h"
 #include <vector>
 #include <string>
 
 namespace phot{
-  
+
   class PhotonLibrary
   {
   public:
     PhotonLibrary();
     ~PhotonLibrary();
 
-    float GetCount(size_t Voxel, size_t OpChannel);
+    PhotonLibrary(const PhotonLibrary&) = delete;
+    PhotonLibrary& operator=(const PhotonLibrary&) = delete;
+
+    float GetCount(size_t Voxel, size_t OpChannel) const;
     void   SetCount(size_t Voxel, size_t OpChannel, float Count);
-    
-    const std::vector<float>* GetCounts(size_t Voxel) const;
-    inline const std::vector<std::vector<float> >& GetData() const
-    { return fLookupTable; }
-    
+
+    VisibilitySpan GetCounts(size_t Voxel) const;
+
     void StoreLibraryToFile(std::string LibraryFile);
     void LoadLibraryFromFile(std::string LibraryFile, size_t NVoxels);
     void CreateEmptyLibrary(size_t NVoxels, size_t NChannels);
-    
+
+    /// Write the library in the flat binary format (header + voxel-major float array)
+    void StoreLibraryToFlatFile(std::string LibraryFile, const sim::PhotonVoxelDef& VoxelDef) const;
+    /// Memory-map a flat binary library; the voxel definition must match the file header
+    void LoadLibraryFromFlatFile(std::string LibraryFile, const sim::PhotonVoxelDef& VoxelDef);
+    /// True if the library is backed by a memory-mapped flat file (read-only)
+    bool IsMapped() const { return fMapAddr != nullptr; }
 
     int NOpChannels() const { return fNOpChannels; }
     int NVoxels() const { return fNVoxels; }
-    
+
   private:
-    // fLookupTable[Voxel]->at(OpChannel) = Count
-    std::vector<std::vector<float> > fLookupTable;
+
+    void Unmap();
+
+    // fData[Voxel * fNOpChannels + OpChannel] = Count
+    std::vector<float> fLookupTable; ///< Owned storage (ROOT library or build job)
+    const float* fData;              ///< Points to fLookupTable or into the mapping
     size_t fNOpChannels;
     size_t fNVoxels;
-    
-    static std::vector<float> EmptyChannelsList;
-    
-    static std::vector<float>* EmptyList()
-      { EmptyChannelsList.clear(); return &EmptyChannelsList; }
+
+    void*  fMapAddr;                 ///< Start of the flat file mapping (nullptr if none)
+    size_t fMapSize;                 ///< Size of the flat file mapping
   };
 
 }
@@ -103,7 +103,7 @@ namespace phot{
       for(int iz=0; iz<fNz; ++iz) {
 	int vox_id = iy*fNx + iz * (fNy + fNx);
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
+	for(auto const& vis_pmt : fTheLibrary->GetCounts(vox_id))
 	  vis_sum += ((double)(vis_pmt));
 	result[iy][iz] = vis_sum;
       }
@@ -123,7 +123,7 @@ namespace phot{
       for(int iz=0; iz<fNz; ++iz) {
 	int vox_id = ix + iz * (fNy + fNx);
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
+	for(auto const& vis_pmt : fTheLibrary->GetCounts(vox_id))
 	  vis_sum += ((double)(vis_pmt));
 	result[iz][ix] = vis_sum;
       }
@@ -143,7 +143,7 @@ namespace phot{
       for(int iy=0; iy<fNy; ++iy) {
 	int vox_id = ix + iy * fNx;
 	double vis_sum = 0.;
-	for(auto const& vis_pmt : *(fTheLibrary->GetCounts(vox_id)))
+	for(auto const& vis_pmt : fTheLibrary->GetCounts(vox_id))
 	  vis_sum += ((double)(vis_pmt));
 	result[ix][iy] = vis_sum;
       }
@@ -184,8 +184,16 @@ namespace phot{
 	  std::cout << "PhotonVisibilityService Loading photon library from file "
 		    << LibraryFileWithPath
 		    << std::endl;
-	  size_t NVoxels = GetVoxelDef().GetNVoxels();
-	  fTheLibrary->LoadLibraryFromFile(LibraryFileWithPath, NVoxels);
+	  // ROOT libraries are read into memory, anything else is taken to be
+	  // a flat library (see StoreFlatLibrary) and memory-mapped
+	  size_t const ext = LibraryFileWithPath.rfind(".root");
+	  if(ext != std::string::npos && ext + 5 == LibraryFileWithPath.size()) {
+	    size_t NVoxels = GetVoxelDef().GetNVoxels();
+	    fTheLibrary->LoadLibraryFromFile(LibraryFileWithPath, NVoxels);
+	  }
+	  else {
+	    fTheLibrary->LoadLibraryFromFlatFile(LibraryFileWithPath, GetVoxelDef());
+	  }
 	}
       }
       else {
@@ -214,6 +222,15 @@ namespace phot{
       }
   }
 
+  //--------------------------------------------------------------------
+  void PhotonVisibilityService::StoreFlatLibrary(std::string FlatLibraryFile) const
+  {
+    if(fTheLibrary == 0)
+      LoadLibrary();
+
+    fTheLibrary->StoreLibraryToFlatFile(FlatLibraryFile, fVoxelDef);
+  }
+
 
   //------------------------------------------------------
 
@@ -232,7 +249,7 @@ namespace phot{
   // Get a vector of the relative visibilities of each OpDet
   //  in the event to a point xyz
 
-  const std::vector<float>* PhotonVisibilityService::GetAllVisibilities(double * xyz) const
+  VisibilitySpan PhotonVisibilityService::GetAllVisibilities(double * xyz) const
   {
     int VoxID = fVoxelDef.GetVoxelID(xyz);
     return GetLibraryEntries(VoxID);
@@ -311,7 +328,7 @@ namespace phot{
 
 
 
-  const std::vector<float>* PhotonVisibilityService::GetLibraryEntries(int VoxID) const
+  VisibilitySpan PhotonVisibilityService::GetLibraryEntries(int VoxID) const
   {
     if(fTheLibrary == 0)
       LoadLibrary();
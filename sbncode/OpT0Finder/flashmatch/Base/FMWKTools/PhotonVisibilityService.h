@@ -16,6 +16,7 @@
 //#include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
 #include "PhotonLibrary.h"
 #include "PhotonVoxels.h"
+#include "VisibilitySpan.h"
 #include <cassert>
 
 ///General LArSoft Utilities
@@ -56,13 +57,12 @@ namespace phot{
     inline int    GetNZ() const { return fNz; }
     inline size_t GetNOpChannels() const { return fNOpDetChannels; }
 
-    const std::vector<float>* GetAllVisibilities( double* xyz ) const;
+    VisibilitySpan GetAllVisibilities( double* xyz ) const;
 
-    inline const std::vector<std::vector<float> >& GetLibraryData() const
-    { if(!fTheLibrary) LoadLibrary(); return fTheLibrary->GetData(); }
-    
     void LoadLibrary() const;
     void StoreLibrary();
+    /// Convert the loaded library into the flat, memory-mappable format
+    void StoreFlatLibrary(std::string FlatLibraryFile) const;
     
     
     void StoreLightProd(    int  VoxID,  double  N );
@@ -70,7 +70,7 @@ namespace phot{
     
     void SetLibraryEntry(   int VoxID, int OpChannel, float N);
     float GetLibraryEntry( int VoxID, int OpChannel) const;
-    const std::vector<float>* GetLibraryEntries( int VoxID ) const;
+    VisibilitySpan GetLibraryEntries( int VoxID ) const;
 
     
     bool IsBuildJob() const { return fLibraryBuildJob; }
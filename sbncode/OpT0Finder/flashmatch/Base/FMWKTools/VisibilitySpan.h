@@ -0,0 +1,36 @@
+/*
+  VisibilitySpan: non-owning view over the per-channel visibilities of one
+  photon library voxel. The underlying memory belongs to the PhotonLibrary
+  (either its in-memory table or the memory-mapped flat library file), so a
+  span is only valid as long as the library that produced it.
+ */
+
+#ifndef VISIBILITYSPAN_H
+#define VISIBILITYSPAN_H
+
+#include <cstddef>
+
+namespace phot{
+
+  class VisibilitySpan
+  {
+  public:
+    VisibilitySpan() : fData(nullptr), fSize(0) {}
+    VisibilitySpan(const float* data, size_t size) : fData(data), fSize(size) {}
+
+    inline const float* begin() const { return fData; }
+    inline const float* end()   const { return fData + fSize; }
+    inline const float* data()  const { return fData; }
+    inline size_t size()  const { return fSize; }
+    inline bool   empty() const { return fSize == 0; }
+
+    inline float operator[](size_t OpChannel) const { return fData[OpChannel]; }
+
+  private:
+    const float* fData;
+    size_t fSize;
+  };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef OPT0FINDER_FLASHMATCHMANAGER_CXX
 #define OPT0FINDER_FLASHMATCHMANAGER_CXX
 
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <set>
@@ -14,6 +15,12 @@
 #include "CustomAlgoFactory.h"
 #include <chrono>
 
+#if USING_LARSOFT == 1
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+#endif
+
 using namespace std::chrono;
 namespace flashmatch {
 
@@ -26,10 +33,18 @@ namespace flashmatch {
     , _alg_flash_hypothesis(nullptr)
     , _configured(false)
     , _name(name)
+    , _num_threads(1)
   {
     _allow_reuse_flash = true;
   }
 
+  FlashMatchManager::~FlashMatchManager()
+  {
+    // Only the per-thread clones are owned by the manager
+    for (size_t i = 1; i < _alg_flash_match_v.size(); ++i) delete _alg_flash_match_v[i];
+    for (size_t i = 1; i < _alg_flash_hypothesis_v.size(); ++i) delete _alg_flash_hypothesis_v[i];
+  }
+
   const std::string& FlashMatchManager::Name() const
   { return _name; }
 
@@ -103,6 +118,7 @@ namespace flashmatch {
     _allow_reuse_flash = mgr_cfg.get<bool>("AllowReuseFlash");
     this->set_verbosity((msg::Level_t)(mgr_cfg.get<unsigned int>("Verbosity")));
     _store_full = mgr_cfg.get<bool>("StoreFullResult");
+    _num_threads = std::max(1u, mgr_cfg.get<unsigned int>("NumThreads", 1));
 
     auto const flash_filter_name = mgr_cfg.get<std::string>("FlashFilterAlgo","");
     auto const tpc_filter_name   = mgr_cfg.get<std::string>("TPCFilterAlgo","");
@@ -132,6 +148,42 @@ namespace flashmatch {
       _alg_flash_match->Configure(main_cfg.get<flashmatch::Config_t>(_alg_flash_match->AlgorithmName()));
     }
 
+    // Per-thread matching algorithm instances, each with its own hypothesis instance
+    for (size_t i = 1; i < _alg_flash_match_v.size(); ++i) delete _alg_flash_match_v[i];
+    for (size_t i = 1; i < _alg_flash_hypothesis_v.size(); ++i) delete _alg_flash_hypothesis_v[i];
+    _alg_flash_match_v.clear();
+    _alg_flash_hypothesis_v.clear();
+    if (_alg_flash_hypothesis) _alg_flash_hypothesis_v.push_back(_alg_flash_hypothesis);
+    if (_alg_flash_match) {
+      _alg_flash_match_v.push_back(_alg_flash_match);
+      for (size_t i = 1; i < _num_threads; ++i) {
+        BaseFlashHypothesis* hypo = nullptr;
+        if (_alg_flash_hypothesis) {
+          hypo = FlashHypothesisFactory::get().create(hypothesis_name,hypothesis_name);
+          if (hypo == _alg_flash_hypothesis) {
+            FLASH_WARNING() << hypothesis_name
+                            << " is a shared instance: concurrent matching disabled" << std::endl;
+            break;
+          }
+          hypo->Configure(main_cfg.get<flashmatch::Config_t>(hypo->AlgorithmName()));
+        }
+        auto ptr = _alg_flash_match->Clone();
+        if (!ptr) {
+          FLASH_WARNING() << _alg_flash_match->AlgorithmName()
+                          << " does not support concurrent matching: using 1 thread" << std::endl;
+          delete hypo;
+          break;
+        }
+        ptr->SetFlashHypothesis(hypo);
+        _alg_flash_match_v.push_back(ptr);
+        if (hypo) _alg_flash_hypothesis_v.push_back(hypo);
+      }
+    }
+    // The hypothesis instances share the services they read from
+    for (auto hypo : _alg_flash_hypothesis_v) hypo->SetConcurrent(_alg_flash_hypothesis_v.size() > 1);
+    // The clones are created after any earlier SetTPCCryo call
+    for (auto alg : _alg_flash_match_v) alg->SetTPCCryo(_tpc, _cryo);
+
     for (auto& name_ptr : _custom_alg_m)
       name_ptr.second->Configure(main_cfg.get<flashmatch::Config_t>(name_ptr.first));
 
@@ -261,7 +313,9 @@ namespace flashmatch {
     std::multimap<double, FlashMatch_t> score_map;
 
     // Double loop over a list of tpc object & flash
-    // Call matching function to inspect the compatibility.
+    // to collect the pairs to inspect.
+    std::vector<std::pair<size_t, ID_t> > pair_v;
+    pair_v.reserve(tpc_index_v.size() * flash_index_v.size());
     for (size_t tpc_index = 0; tpc_index < tpc_index_v.size(); ++tpc_index) {
       // Loop over flash list
       for (auto const& flash_index : flash_index_v) {
@@ -280,35 +334,75 @@ namespace flashmatch {
             continue;
           }
         }
-        auto start = high_resolution_clock::now();
-        auto res = _alg_flash_match->Match( tpc, flash ); // Run matching
-        auto end = high_resolution_clock::now();
-        auto duration = duration_cast<nanoseconds>(end - start);
-        FLASH_INFO() << "Match duration = " << duration.count() << "ns" << std::endl;
-
-        // ignore this match if the score is <= 0
-        if (res.score <= 0) continue;
-
-        // Else we store this match. Assign TPC & flash index info
-        res.tpc_id = tpc_index_v[tpc_index];//_index;
-        res.flash_id = flash_index;//_index;
-        res.duration = duration.count();
+        pair_v.emplace_back(tpc_index, flash_index);
+      }
+    }
 
+    // Call matching function to inspect the compatibility.
+    // Each pair has its own result slot, so they can be evaluated in any
+    // order by any of the per-thread algorithm instances.
+    std::vector<FlashMatch_t> pair_res_v(pair_v.size());
+    auto match_pair = [&](size_t pair_index, BaseFlashMatch* alg) {
+      auto const& tpc   = _tpc_object_v[tpc_index_v[pair_v[pair_index].first]];
+      auto const& flash = _flash_v[pair_v[pair_index].second];
+      auto start = high_resolution_clock::now();
+      auto res = alg->Match( tpc, flash ); // Run matching
+      auto end = high_resolution_clock::now();
+      auto duration = duration_cast<nanoseconds>(end - start);
+      FLASH_INFO() << "Match duration = " << duration.count() << "ns" << std::endl;
+      res.duration = duration.count();
+      pair_res_v[pair_index] = std::move(res);
+    };
+
+    #if USING_LARSOFT == 1
+    if (_alg_flash_match_v.size() > 1 && pair_v.size() > 1) {
+      // Consecutive pairs share the TPC object, so keep contiguous chunks on one instance
+      tbb::task_arena arena(_alg_flash_match_v.size());
+      arena.execute([&] {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, pair_v.size()),
+                          [&](tbb::blocked_range<size_t> const& range) {
+                            auto alg = _alg_flash_match_v[tbb::this_task_arena::current_thread_index()];
+                            for (size_t pair_index = range.begin(); pair_index != range.end(); ++pair_index)
+                              match_pair(pair_index, alg);
+                          });
+      });
+    }
+    else
+    #endif
+    {
+      for (size_t pair_index = 0; pair_index < pair_v.size(); ++pair_index)
+        match_pair(pair_index, _alg_flash_match);
+    }
 
-        if(_store_full) {
-          _res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
-          _res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
-        }
-        // For ordering purpose, take an inverse of the score for sorting
-        score_map.emplace( 1. / res.score, res);
-
-        FLASH_DEBUG() << "Candidate Match: "
-		      << " TPC=" << tpc_index << " (" << tpc.min_x() << " min x)" << " @ " << tpc.time
-		      << " with Flash=" << flash_index << " @ " << flash.time
-		      << " ... Score=" << res.score
-		      << " ... PE=" << flash.TotalPE()
-		      << std::endl;
+    // Merge in the serial (tpc, flash) order so that equally-scored
+    // matches keep the same order in the multimap whatever the threading
+    for (size_t pair_index = 0; pair_index < pair_v.size(); ++pair_index) {
+      auto& res = pair_res_v[pair_index];
+      auto const& tpc_index   = pair_v[pair_index].first;
+      auto const& flash_index = pair_v[pair_index].second;
+      auto const& tpc   = _tpc_object_v[tpc_index_v[tpc_index]];
+      auto const& flash = _flash_v[flash_index];
+
+      // ignore this match if the score is <= 0
+      if (res.score <= 0) continue;
+
+      // Else we store this match. Assign TPC & flash index info
+      res.tpc_id = tpc_index_v[tpc_index];//_index;
+      res.flash_id = flash_index;//_index;
+
+      if(_store_full) {
+        _res_tpc_flash_v[res.tpc_id][res.flash_id] = res;
+        _res_flash_tpc_v[res.flash_id][res.tpc_id] = res;
       }
+      // For ordering purpose, take an inverse of the score for sorting
+      score_map.emplace( 1. / res.score, res);
+
+      FLASH_DEBUG() << "Candidate Match: "
+		    << " TPC=" << tpc_index << " (" << tpc.min_x() << " min x)" << " @ " << tpc.time
+		    << " with Flash=" << flash_index << " @ " << flash.time
+		    << " ... Score=" << res.score
+		    << " ... PE=" << flash.TotalPE()
+		    << std::endl;
     }
 
     // We have a score-ordered list of match information at this point.
@@ -383,28 +477,32 @@ namespace flashmatch {
       throw OpT0FinderException("Flash hypothesis algorithm is required to set channel mask!");
     }
 
-    _alg_flash_hypothesis->SetChannelMask(ch_mask);
+    for (auto hypo : _alg_flash_hypothesis_v) {
+      hypo->SetChannelMask(ch_mask);
+    }
   }
 
   void FlashMatchManager::SetTPCCryo(int tpc, int cryo) {
     _tpc = tpc;
     _cryo = cryo;
 
-    if (_alg_flash_match) {
-      _alg_flash_match->SetTPCCryo(_tpc, _cryo);
+    for (auto alg : _alg_flash_match_v) {
+      alg->SetTPCCryo(_tpc, _cryo);
     }
   }
 
   void FlashMatchManager::SetUncoatedPMTs(std::vector<int> ch_uncoated) {
-    if (_alg_flash_hypothesis) {
-      _alg_flash_hypothesis->SetUncoatedPMTs(ch_uncoated);
+    for (auto hypo : _alg_flash_hypothesis_v) {
+      hypo->SetUncoatedPMTs(ch_uncoated);
     }
   }
 
   #if USING_LARSOFT == 1
   void FlashMatchManager::SetSemiAnalyticalModel(std::unique_ptr<phot::SemiAnalyticalModel> model) {
-    if (_alg_flash_hypothesis) {
-      _alg_flash_hypothesis->SetSemiAnalyticalModel(std::move(model));
+    // The model is only read by the hypotheses, so the per-thread instances share it
+    std::shared_ptr<phot::SemiAnalyticalModel> shared_model(std::move(model));
+    for (auto hypo : _alg_flash_hypothesis_v) {
+      hypo->SetSemiAnalyticalModel(shared_model);
     }
   }
   #endif
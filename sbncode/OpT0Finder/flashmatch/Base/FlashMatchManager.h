@@ -34,7 +34,7 @@ namespace flashmatch {
     FlashMatchManager(const std::string name="FlashMatchManager");
     
     /// Default destructor
-    ~FlashMatchManager(){}
+    ~FlashMatchManager();
 
     /// Name getter
     const std::string& Name() const;
@@ -116,6 +116,11 @@ namespace flashmatch {
     BaseFlashMatch*      _alg_flash_match;      ///< Flash matching algorithm
     BaseFlashHypothesis* _alg_flash_hypothesis; ///< Flash hypothesis algorithm
 
+    /// Flash matching algorithm instances, one per thread (the first one is _alg_flash_match)
+    std::vector<BaseFlashMatch*> _alg_flash_match_v;
+    /// Flash hypothesis algorithm instances, one per flash matching instance (the first one is _alg_flash_hypothesis)
+    std::vector<BaseFlashHypothesis*> _alg_flash_hypothesis_v;
+
     /**
        A set of custom algorithms (not to be executed but to be configured)
     */
@@ -135,6 +140,8 @@ namespace flashmatch {
     std::string _name;
     /// Request boolean to store full matching result (per Match function call)
     bool _store_full;
+    /// Number of threads used to evaluate TPC object & flash pairs
+    size_t _num_threads;
     /// Full result container indexed by [tpc][flash]
     std::vector<std::vector<flashmatch::FlashMatch_t> > _res_tpc_flash_v;
     /// Full result container indexed by [flash][tpc]
@@ -0,0 +1,280 @@
+#include "sbncode/PID/BDTEvaluator.h"
+
+#include "cetlib_except/exception.h"
+
+#include "TXMLEngine.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace {
+// Same buffer size as TMVA uses to parse its weight files
+constexpr int kXMLBufferSize = 10000000;
+
+// Frees the parsed document on every exit path
+struct XMLDocument {
+  TXMLEngine& xml;
+  XMLDocPointer_t doc;
+  ~XMLDocument()
+  {
+    if (doc)
+      xml.FreeDoc(doc);
+  }
+};
+
+bool HasName(TXMLEngine& xml, XMLNodePointer_t node, const char* name)
+{
+  return std::string(xml.GetNodeName(node)) == name;
+}
+
+std::string GetAttr(TXMLEngine& xml, XMLNodePointer_t node, const char* name)
+{
+  const char* value(xml.GetAttr(node, name));
+  return value ? value : "";
+}
+
+float GetFloatAttr(TXMLEngine& xml, XMLNodePointer_t node, const char* name, float def)
+{
+  const char* value(xml.GetAttr(node, name));
+  return value ? std::strtof(value, nullptr) : def;
+}
+
+int GetIntAttr(TXMLEngine& xml, XMLNodePointer_t node, const char* name, int def)
+{
+  const char* value(xml.GetAttr(node, name));
+  return value ? std::atoi(value) : def;
+}
+}
+
+namespace sbn {
+
+void BDTFeatures::Add(std::initializer_list<float> values)
+{
+  if (fColumns.empty())
+    fColumns.resize(values.size());
+
+  if (values.size() != fColumns.size())
+    throw cet::exception("BDTFeatures") << "Adding " << values.size() << " variables to a batch of " << fColumns.size();
+
+  auto column(fColumns.begin());
+  for (const float value : values)
+    (column++)->push_back(value);
+}
+
+void BDTFeatures::Clear()
+{
+  for (std::vector<float>& column : fColumns)
+    column.clear();
+}
+
+BDTEvaluator::BDTEvaluator(const std::string& weightFile, const std::vector<std::string>& variables)
+    : fNVars(variables.size())
+    , fNClasses(2)
+    , fGradBoost(false)
+{
+  TXMLEngine xml;
+  xml.SetSkipComments(true);
+  XMLDocument doc { xml, xml.ParseFile(weightFile.c_str(), kXMLBufferSize) };
+  if (!doc.doc)
+    throw cet::exception("BDTEvaluator") << "Unable to parse weight file: " << weightFile;
+
+  XMLNodePointer_t setup(xml.DocGetRootElement(doc.doc));
+  const std::string method(GetAttr(xml, setup, "Method"));
+  if (!HasName(xml, setup, "MethodSetup") || method.compare(0, 5, "BDT::") != 0)
+    throw cet::exception("BDTEvaluator") << "Weight file " << weightFile << " is not for a TMVA BDT: " << method;
+
+  std::map<std::string, std::string> options;
+  std::vector<std::string> fileVariables;
+  XMLNodePointer_t weights(nullptr);
+
+  for (XMLNodePointer_t node = xml.GetChild(setup); node; node = xml.GetNext(node)) {
+    if (HasName(xml, node, "Options")) {
+      for (XMLNodePointer_t option = xml.GetChild(node); option; option = xml.GetNext(option)) {
+        const char* content(xml.GetNodeContent(option));
+        options[GetAttr(xml, option, "name")] = content ? content : "";
+      }
+    }
+    else if (HasName(xml, node, "Variables")) {
+      for (XMLNodePointer_t var = xml.GetChild(node); var; var = xml.GetNext(var))
+        fileVariables.push_back(GetAttr(xml, var, "Expression"));
+    }
+    else if (HasName(xml, node, "Classes")) {
+      fNClasses = GetIntAttr(xml, node, "NClass", 2);
+    }
+    else if (HasName(xml, node, "Transformations")) {
+      if (GetIntAttr(xml, node, "NTransformations", 0) != 0)
+        throw cet::exception("BDTEvaluator") << "Variable transformations are not supported, in " << weightFile;
+    }
+    else if (HasName(xml, node, "Weights")) {
+      weights = node;
+    }
+  }
+
+  if (fileVariables != variables) {
+    cet::exception error("BDTEvaluator");
+    error << "Variables do not match the training in " << weightFile << "\n  expected:";
+    for (const std::string& var : fileVariables)
+      error << " " << var;
+    error << "\n  given:";
+    for (const std::string& var : variables)
+      error << " " << var;
+    throw error;
+  }
+
+  auto const isTrue = [&options](const std::string& name, bool def) {
+    auto const iter(options.find(name));
+    return (iter == options.end()) ? def : (iter->second == "True" || iter->second == "true" || iter->second == "1");
+  };
+  if (isTrue("DoPreselection", false) || isTrue("UseFisherCuts", false))
+    throw cet::exception("BDTEvaluator") << "Preselection and Fisher cuts are not supported, in " << weightFile;
+
+  fGradBoost = (options.count("BoostType") && options.at("BoostType") == "Grad");
+  const bool useYesNoLeaf(isTrue("UseYesNoLeaf", true));
+
+  if (!weights)
+    throw cet::exception("BDTEvaluator") << "No trees in weight file: " << weightFile;
+
+  for (XMLNodePointer_t tree = xml.GetChild(weights); tree; tree = xml.GetNext(tree)) {
+    XMLNodePointer_t root(xml.GetChild(tree));
+    if (!root)
+      throw cet::exception("BDTEvaluator") << "Empty tree in weight file: " << weightFile;
+
+    fBoostWeights.push_back(std::strtod(GetAttr(xml, tree, "boostWeight").c_str(), nullptr));
+    fRoots.push_back(fNodes.size());
+    fNodes.emplace_back();
+
+    // Lay the tree out breadth first, so both children of a node are adjacent
+    std::deque<std::pair<XMLNodePointer_t, unsigned>> queue { { root, fRoots.back() } };
+    while (!queue.empty()) {
+      auto const [xmlNode, index] = queue.front();
+      queue.pop_front();
+
+      Node node { -1, 0.f, 0, 0.f };
+
+      // TMVA walks down while the node type is 0, and reads the leaves' type otherwise
+      const int nodeType(GetIntAttr(xml, xmlNode, "nType", 0));
+      if (nodeType != 0) {
+        // Gradient boosted trees return the leaf response, as in TMVA::DecisionTree::CheckEvent
+        node.value = fGradBoost ? GetFloatAttr(xml, xmlNode, "res", -99.f)
+                   : useYesNoLeaf ? nodeType
+                                  : GetFloatAttr(xml, xmlNode, "purity", -1.f);
+        fNodes[index] = node;
+        continue;
+      }
+
+      XMLNodePointer_t left(nullptr), right(nullptr);
+      for (XMLNodePointer_t child = xml.GetChild(xmlNode); child; child = xml.GetNext(child)) {
+        const std::string pos(GetAttr(xml, child, "pos"));
+        if (pos == "l")
+          left = child;
+        else if (pos == "r")
+          right = child;
+      }
+
+      node.var = GetIntAttr(xml, xmlNode, "IVar", -1);
+      node.cut = GetFloatAttr(xml, xmlNode, "Cut", 0.f);
+      if (!left || !right || node.var < 0 || node.var >= (int)fNVars || GetIntAttr(xml, xmlNode, "NCoef", 0) > 0)
+        throw cet::exception("BDTEvaluator") << "Unsupported node in tree " << fRoots.size() - 1 << " of " << weightFile;
+
+      // With cType 0 the cut selects the left child, so store the children the other way round
+      const bool cutType(GetIntAttr(xml, xmlNode, "cType", 1));
+      node.child = fNodes.size();
+      fNodes.emplace_back();
+      fNodes.emplace_back();
+      fNodes[index] = node;
+      queue.emplace_back(cutType ? left : right, node.child);
+      queue.emplace_back(cutType ? right : left, node.child + 1);
+    }
+  }
+}
+
+void BDTEvaluator::CheckFeatures(const BDTFeatures& features) const
+{
+  if (!features.Empty() && features.NVariables() != fNVars)
+    throw cet::exception("BDTEvaluator") << "Evaluating " << features.NVariables() << " variables with a BDT of " << fNVars;
+}
+
+void BDTEvaluator::SumTrees(const BDTFeatures& features, bool multiclass, bool weighted, std::vector<double>& sums) const
+{
+  const size_t nEntries(features.NEntries());
+  const size_t stride(multiclass ? fNClasses : 1);
+  sums.assign(nEntries * stride, 0.);
+  if (!nEntries)
+    return;
+
+  std::vector<const float*> columns(fNVars);
+  for (size_t ivar = 0; ivar < fNVars; ivar++)
+    columns[ivar] = features.Column(ivar).data();
+
+  for (size_t itree = 0; itree < fRoots.size(); itree++) {
+    // Multiclass forests cycle through the classes tree by tree
+    const size_t iclass(multiclass ? itree % fNClasses : 0);
+    const double weight(weighted ? fBoostWeights[itree] : 1.);
+    const unsigned root(fRoots[itree]);
+
+    for (size_t i = 0; i < nEntries; i++) {
+      unsigned inode(root);
+      while (fNodes[inode].var >= 0) {
+        const Node& node(fNodes[inode]);
+        inode = node.child + (columns[node.var][i] >= node.cut);
+      }
+      sums[i * stride + iclass] += weight * fNodes[inode].value;
+    }
+  }
+}
+
+std::vector<float> BDTEvaluator::EvaluateMVA(const BDTFeatures& features) const
+{
+  this->CheckFeatures(features);
+
+  std::vector<double> sums;
+  this->SumTrees(features, false, !fGradBoost, sums);
+
+  double norm(0.);
+  for (const double weight : fBoostWeights)
+    norm += weight;
+
+  std::vector<float> mva(sums.size());
+  for (size_t i = 0; i < sums.size(); i++) {
+    // TMVA::Reader refuses to evaluate NaN inputs
+    bool hasNaN(false);
+    for (size_t ivar = 0; ivar < fNVars; ivar++)
+      hasNaN |= std::isnan(features.Column(ivar)[i]);
+
+    if (hasNaN)
+      mva[i] = -999.f;
+    else if (fGradBoost)
+      mva[i] = 2.0 / (1.0 + std::exp(-2.0 * sums[i])) - 1;
+    else
+      mva[i] = (norm > std::numeric_limits<double>::epsilon()) ? sums[i] / norm : 0.;
+  }
+  return mva;
+}
+
+std::vector<float> BDTEvaluator::EvaluateMulticlass(const BDTFeatures& features) const
+{
+  if (!fGradBoost)
+    throw cet::exception("BDTEvaluator") << "Multiclass evaluation needs a gradient boosted forest";
+
+  this->CheckFeatures(features);
+
+  std::vector<double> sums;
+  this->SumTrees(features, true, false, sums);
+
+  std::vector<float> probs(sums.size());
+  for (size_t i = 0; i < sums.size(); i += fNClasses) {
+    double expSum(0.);
+    for (size_t iclass = 0; iclass < fNClasses; iclass++) {
+      sums[i + iclass] = std::exp(sums[i + iclass]);
+      expSum += sums[i + iclass];
+    }
+    for (size_t iclass = 0; iclass < fNClasses; iclass++)
+      probs[i + iclass] = sums[i + iclass] / expSum;
+  }
+  return probs;
+}
+}
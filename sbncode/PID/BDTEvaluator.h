@@ -0,0 +1,89 @@
+#ifndef SBNCODE_PID_BDTEVALUATOR_H
+#define SBNCODE_PID_BDTEVALUATOR_H
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace sbn {
+
+/**
+ * @file  sbncode/PID/BDTEvaluator.h
+ * @class sbn::BDTFeatures
+ *
+ * @brief Input variables of a batch of objects, stored one column per variable
+ */
+class BDTFeatures {
+  public:
+  /// Append an object, with its variables in the training order
+  void Add(std::initializer_list<float> values);
+
+  size_t NVariables() const { return fColumns.size(); }
+  size_t NEntries() const { return fColumns.empty() ? 0 : fColumns.front().size(); }
+  bool Empty() const { return NEntries() == 0; }
+
+  const std::vector<float>& Column(size_t ivar) const { return fColumns[ivar]; }
+
+  /// Remove the objects, keeping the allocated columns
+  void Clear();
+
+  private:
+  std::vector<std::vector<float>> fColumns;
+};
+
+/**
+ * @class sbn::BDTEvaluator
+ *
+ * @brief Boosted decision tree trained with TMVA, evaluated without TMVA::Reader
+ *
+ * The forest is read once from the TMVA weight file and flattened into a
+ * single node array. The two children of a node are stored next to each
+ * other, breadth first within each tree, and a cut selects between them with
+ * the same inclusive comparison as TMVA::DecisionTreeNode::GoesRight. A batch
+ * of objects is evaluated one tree at a time, so each tree stays in cache
+ * while all objects go through it, and the tree responses are summed per
+ * object in the training order, as MethodBDT does.
+ *
+ * Gradient boosted (classification and multiclass) and AdaBoost-style forests
+ * are supported. Weight files with variable transformations, Fisher cuts or
+ * preselection cuts are rejected.
+ */
+class BDTEvaluator {
+  public:
+  /// @param weightFile  path of the TMVA weight file (XML)
+  /// @param variables   names of the input variables, in the training order
+  BDTEvaluator(const std::string& weightFile, const std::vector<std::string>& variables);
+
+  size_t NVariables() const { return fNVars; }
+  size_t NClasses() const { return fNClasses; }
+  size_t NTrees() const { return fRoots.size(); }
+
+  /// Classifier response of each object, as TMVA::Reader::EvaluateMVA
+  std::vector<float> EvaluateMVA(const BDTFeatures& features) const;
+
+  /// Class probabilities, NClasses() consecutive values per object, as TMVA::Reader::EvaluateMulticlass
+  std::vector<float> EvaluateMulticlass(const BDTFeatures& features) const;
+
+  private:
+  struct Node {
+    int var;        ///< variable cut on, -1 for a leaf
+    float cut;      ///< cut value; the second child is taken if the variable is >= cut
+    unsigned child; ///< index of the first of the two children
+    float value;    ///< response of a leaf
+  };
+
+  /// Sum the weighted response of every tree into sums, NClasses() per object if multiclass
+  void SumTrees(const BDTFeatures& features, bool multiclass, bool weighted, std::vector<double>& sums) const;
+  void CheckFeatures(const BDTFeatures& features) const;
+
+  size_t fNVars;
+  size_t fNClasses;
+  bool fGradBoost;
+
+  std::vector<Node> fNodes;
+  std::vector<unsigned> fRoots;     ///< root node of each tree
+  std::vector<double> fBoostWeights; ///< weight of each tree
+};
+}
+
+#endif
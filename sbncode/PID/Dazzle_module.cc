@@ -50,6 +50,8 @@
 #include "sbnobj/Common/Reco/ScatterClosestApproach.h"
 #include "sbnobj/Common/Reco/StoppingChi2Fit.h"
 
+#include "sbncode/PID/BDTEvaluator.h"
+
 // #include "sbncode/LArRecoProducer/LArReco/LGfitter.h"
 
 // Root Includes
@@ -60,11 +62,8 @@
 #include "TMath.h"
 #include "TTree.h"
 
-#include "TMVA/MethodCuts.h"
-#include "TMVA/Reader.h"
-#include "TMVA/Tools.h"
-
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <numeric> // std::accumulate
 
@@ -111,7 +110,7 @@ class Dazzle : public art::EDProducer {
   // float lgcMPV;                                  // Most Probable value of fitted Landau-Guassian [MeV/cm]
   float chi2Pol0Fit; // Fitted pol0 to find the dE/dx of the track [MeV/cm]
   float pDiff;       // Relatve momentum agreement between range and MCS
-  //TODO: Root insists that we pass the reader floats, but these should really be ints
+  //TODO: The MVA takes floats, but these should really be ints
   float numDaughters, maxDaughterHits; // Hierarchy of the track
 
   // MVA scores
@@ -119,7 +118,7 @@ class Dazzle : public art::EDProducer {
   int bestPDG;
 
   // Other metrics for filling in tree for analysis
-  TMVA::Reader* reader;
+  std::unique_ptr<BDTEvaluator> bdt;
   TTree* trackTree;
 
   int truePdg, chi2PIDPDG, chi2PIDPDGNoKaon, numHits, bestPlane, bestPlaneHits, hierarchyDepth, trueStopping, recoContained, recoPrimary;
@@ -146,7 +145,8 @@ class Dazzle : public art::EDProducer {
   // void FillLGCMetrics(const LGCFit& lgc);
   void FillClosestApproachMetrics(const ScatterClosestApproach& closestApproach);
   void FillStoppingChi2Metrics(const StoppingChi2Fit& stoppingChi2);
-  MVAPID RunMVA();
+  void RunMVA(art::Event& e, BDTFeatures& mvaFeatures, std::vector<art::Ptr<recob::Track>>& mvaTracks,
+      std::vector<MVAPID>& mvaPIDVec, art::Assns<recob::Track, MVAPID>& trackAssns);
 
   std::map<size_t, art::Ptr<recob::PFParticle>> GetPFPMap(std::vector<art::Ptr<recob::PFParticle>>& pfps) const;
   unsigned int GetPFPHierarchyDepth(const art::Ptr<recob::PFParticle>& pfp, const std::map<size_t, art::Ptr<recob::PFParticle>>& pfpMap) const;
@@ -192,26 +192,16 @@ Dazzle::Dazzle(fhicl::ParameterSet const& p)
     if (!searchPath.find_file(fWeightFile, fWeightFileFullPath))
       throw cet::exception("Dazzle") << "Unable to find weight file: " << fWeightFile << " in FW_SEARCH_PATH: " << searchPath.to_string();
 
-    reader = new TMVA::Reader("V");
-
-    reader->AddVariable("recoLen", &recoLen);
-
-    reader->AddVariable("chi2PIDMuon", &chi2PIDMuon);
-    reader->AddVariable("chi2PIDProton", &chi2PIDProton);
-    reader->AddVariable("chi2PIDMuonPionDiff", &chi2PIDMuonPionDiff);
-
-    reader->AddVariable("mcsScatterMean", &mcsScatterMean);
-    reader->AddVariable("mcsScatterMaxRatio", &mcsScatterMaxRatio);
-    reader->AddVariable("meanDCA", &meanDCA);
+    // The order has to match the training, and the features added in produce
+    bdt = std::make_unique<BDTEvaluator>(fWeightFileFullPath,
+        std::vector<std::string> { "recoLen",
+            "chi2PIDMuon", "chi2PIDProton", "chi2PIDMuonPionDiff",
+            "mcsScatterMean", "mcsScatterMaxRatio", "meanDCA",
+            "stoppingChi2Ratio", "chi2Pol0Fit",
+            "pDiff", "numDaughters", "maxDaughterHits" });
 
-    reader->AddVariable("stoppingChi2Ratio", &stoppingChi2Ratio);
-    reader->AddVariable("chi2Pol0Fit", &chi2Pol0Fit);
-
-    reader->AddVariable("pDiff", &pDiff);
-    reader->AddVariable("numDaughters", &numDaughters);
-    reader->AddVariable("maxDaughterHits", &maxDaughterHits);
-
-    reader->BookMVA(fMethodName, fWeightFileFullPath);
+    if (bdt->NClasses() != 4)
+      throw cet::exception("Dazzle") << "Expected 4 classes in weight file: " << fWeightFile << ", found " << bdt->NClasses();
   }
   // Call appropriate produces<>() functions here.
   produces<std::vector<MVAPID>>();
@@ -351,6 +341,10 @@ void Dazzle::produce(art::Event& e)
 
   const std::map<size_t, art::Ptr<recob::PFParticle>> pfpMap(this->GetPFPMap(pfps));
 
+  // Tracks are scored together once all of them are filled
+  BDTFeatures mvaFeatures;
+  std::vector<art::Ptr<recob::Track>> mvaTracks;
+
   for (auto const& pfp : pfps) {
     this->ClearTreeValues();
 
@@ -422,9 +416,16 @@ void Dazzle::produce(art::Event& e)
       this->FillStoppingChi2Metrics(*stoppingChi2Vec.front());
 
     if (fRunMVA) {
-      MVAPID mvaPID(this->RunMVA());
-      mvaPIDVec->push_back(mvaPID);
-      util::CreateAssn(*this, e, *mvaPIDVec, pfpTrack, *trackAssns);
+      mvaFeatures.Add({ recoLen,
+          chi2PIDMuon, chi2PIDProton, chi2PIDMuonPionDiff,
+          mcsScatterMean, mcsScatterMaxRatio, meanDCA,
+          stoppingChi2Ratio, chi2Pol0Fit,
+          pDiff, numDaughters, maxDaughterHits });
+      mvaTracks.push_back(pfpTrack);
+
+      // The tree needs the scores of this track before moving on to the next
+      if (fMakeTree)
+        this->RunMVA(e, mvaFeatures, mvaTracks, *mvaPIDVec, *trackAssns);
     }
 
     // Only fill the truth metrics if we are saving a TTree
@@ -435,6 +436,10 @@ void Dazzle::produce(art::Event& e)
       trackTree->Fill();
     }
   }
+
+  if (fRunMVA)
+    this->RunMVA(e, mvaFeatures, mvaTracks, *mvaPIDVec, *trackAssns);
+
   e.put(std::move(mvaPIDVec));
   e.put(std::move(trackAssns));
 }
@@ -712,29 +717,41 @@ void Dazzle::FillStoppingChi2Metrics(const StoppingChi2Fit& stoppingChi2)
   chi2Pol0Fit = stoppingChi2.pol0Fit;
 }
 
-MVAPID Dazzle::RunMVA()
+void Dazzle::RunMVA(art::Event& e, BDTFeatures& mvaFeatures, std::vector<art::Ptr<recob::Track>>& mvaTracks,
+    std::vector<MVAPID>& mvaPIDVec, art::Assns<recob::Track, MVAPID>& trackAssns)
 {
-  const std::vector<float> mvaScores(reader->EvaluateMulticlass(fMethodName));
+  if (mvaTracks.empty())
+    return;
 
-  MVAPID pidResults;
+  const std::vector<float> mvaScores(bdt->EvaluateMulticlass(mvaFeatures));
 
-  pidResults.AddScore(13, mvaScores.at(0));
-  pidResults.AddScore(211, mvaScores.at(1));
-  pidResults.AddScore(2212, mvaScores.at(2));
-  pidResults.AddScore(0, mvaScores.at(3));
+  for (size_t i = 0; i < mvaTracks.size(); i++) {
+    const float* scores(&mvaScores[i * bdt->NClasses()]);
 
-  if (!fMakeTree)
-    return pidResults;
+    MVAPID pidResults;
+
+    pidResults.AddScore(13, scores[0]);
+    pidResults.AddScore(211, scores[1]);
+    pidResults.AddScore(2212, scores[2]);
+    pidResults.AddScore(0, scores[3]);
 
-  muonScore = mvaScores.at(0);
-  pionScore = mvaScores.at(1);
-  protonScore = mvaScores.at(2);
-  otherScore = mvaScores.at(3);
+    mvaPIDVec.push_back(pidResults);
+    util::CreateAssn(*this, e, mvaPIDVec, mvaTracks[i], trackAssns);
 
-  bestScore = pidResults.BestScore();
-  bestPDG = pidResults.BestPDG();
+    // When making the tree the tracks are scored one at a time
+    if (fMakeTree) {
+      muonScore = scores[0];
+      pionScore = scores[1];
+      protonScore = scores[2];
+      otherScore = scores[3];
+
+      bestScore = pidResults.BestScore();
+      bestPDG = pidResults.BestPDG();
+    }
+  }
 
-  return pidResults;
+  mvaFeatures.Clear();
+  mvaTracks.clear();
 }
 
 void Dazzle::FillChi2PIDMetrics(const anab::ParticleID& pid)
@@ -48,6 +48,8 @@
 #include "sbnobj/Common/Reco/MVAPID.h"
 #include "sbnobj/Common/Reco/ShowerSelectionVars.h"
 
+#include "sbncode/PID/BDTEvaluator.h"
+
 // Root Includes
 #include "TCanvas.h"
 #include "TF1.h"
@@ -56,11 +58,8 @@
 #include "TMath.h"
 #include "TTree.h"
 
-#include "TMVA/MethodCuts.h"
-#include "TMVA/Reader.h"
-#include "TMVA/Tools.h"
-
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <numeric> // std::accumulate
 
@@ -108,7 +107,7 @@ class Razzle : public art::EDProducer {
   int bestPDG;
 
   // Other metrics for filling in tree for analysis
-  TMVA::Reader* reader;
+  std::unique_ptr<BDTEvaluator> bdt;
   TTree* showerTree;
 
   int trackHits;
@@ -130,7 +129,8 @@ class Razzle : public art::EDProducer {
       const recob::Shower& shower, const art::FindManyP<larpandoraobj::PFParticleMetadata>& fmMeta, const art::FindManyP<recob::Vertex>& fmVertex);
   void FillDensityFitMetrics(const ShowerDensityFit& densityFit);
   void FillTrackFitMetrics(const ShowerTrackFit& trackFit);
-  MVAPID RunMVA();
+  void RunMVA(art::Event& e, BDTFeatures& mvaFeatures, std::vector<art::Ptr<recob::Shower>>& mvaShowers,
+      std::vector<MVAPID>& mvaPIDVec, art::Assns<recob::Shower, MVAPID>& showerAssns);
 
   std::map<size_t, art::Ptr<recob::PFParticle>> GetPFPMap(std::vector<art::Ptr<recob::PFParticle>>& pfps) const;
   float GetPFPTrackScore(const art::Ptr<recob::PFParticle>& pfp, const art::FindManyP<larpandoraobj::PFParticleMetadata>& fmMeta) const;
@@ -168,17 +168,12 @@ Razzle::Razzle(fhicl::ParameterSet const& p)
     if (!searchPath.find_file(fWeightFile, fWeightFileFullPath))
       throw cet::exception("Razzle") << "Unable to find weight file: " << fWeightFile << " in FW_SEARCH_PATH: " << searchPath.to_string();
 
-    reader = new TMVA::Reader("V");
+    // The order has to match the training, and the features added in produce
+    bdt = std::make_unique<BDTEvaluator>(fWeightFileFullPath,
+        std::vector<std::string> { "bestdEdx", "convGap", "openAngle", "modHitDensity", "sqrtEnergyDensity" });
 
-    // reader->AddVariable("recoLen", &recoLen);
-    reader->AddVariable("bestdEdx", &bestdEdx);
-    reader->AddVariable("convGap", &convGap);
-    reader->AddVariable("openAngle", &openAngle);
-    reader->AddVariable("modHitDensity", &modHitDensity);
-    // reader->AddVariable("logEnergyDensity", &logEnergyDensity);
-    reader->AddVariable("sqrtEnergyDensity", &sqrtEnergyDensity);
-
-    reader->BookMVA(fMethodName, fWeightFileFullPath);
+    if (bdt->NClasses() != 3)
+      throw cet::exception("Razzle") << "Expected 3 classes in weight file: " << fWeightFile << ", found " << bdt->NClasses();
   }
   // Call appropriate produces<>() functions here.
   produces<std::vector<MVAPID>>();
@@ -280,6 +275,10 @@ void Razzle::produce(art::Event& e)
 
   const std::map<size_t, art::Ptr<recob::PFParticle>> pfpMap(this->GetPFPMap(pfps));
 
+  // Showers are scored together once all of them are filled
+  BDTFeatures mvaFeatures;
+  std::vector<art::Ptr<recob::Shower>> mvaShowers;
+
   for (auto const& pfp : pfps) {
     this->ClearTreeValues();
 
@@ -314,9 +313,12 @@ void Razzle::produce(art::Event& e)
       this->FillTrackFitMetrics(*trackFitVec.front());
 
     if (fRunMVA) {
-      MVAPID mvaPID(this->RunMVA());
-      mvaPIDVec->push_back(mvaPID);
-      util::CreateAssn(*this, e, *mvaPIDVec, pfpShower, *showerAssns);
+      mvaFeatures.Add({ bestdEdx, convGap, openAngle, modHitDensity, sqrtEnergyDensity });
+      mvaShowers.push_back(pfpShower);
+
+      // The tree needs the scores of this shower before moving on to the next
+      if (fMakeTree)
+        this->RunMVA(e, mvaFeatures, mvaShowers, *mvaPIDVec, *showerAssns);
     }
 
     // Only fill the truth metrics if we are saving a TTree
@@ -325,6 +327,10 @@ void Razzle::produce(art::Event& e)
       showerTree->Fill();
     }
   }
+
+  if (fRunMVA)
+    this->RunMVA(e, mvaFeatures, mvaShowers, *mvaPIDVec, *showerAssns);
+
   e.put(std::move(mvaPIDVec));
   e.put(std::move(showerAssns));
 }
@@ -558,27 +564,39 @@ void Razzle::FillTrackFitMetrics(const ShowerTrackFit& trackFit)
   trackHits = trackFit.mNumHits;
 }
 
-MVAPID Razzle::RunMVA()
+void Razzle::RunMVA(art::Event& e, BDTFeatures& mvaFeatures, std::vector<art::Ptr<recob::Shower>>& mvaShowers,
+    std::vector<MVAPID>& mvaPIDVec, art::Assns<recob::Shower, MVAPID>& showerAssns)
 {
-  const std::vector<float> mvaScores(reader->EvaluateMulticlass(fMethodName));
+  if (mvaShowers.empty())
+    return;
 
-  MVAPID pidResults;
+  const std::vector<float> mvaScores(bdt->EvaluateMulticlass(mvaFeatures));
 
-  pidResults.AddScore(11, mvaScores.at(0));
-  pidResults.AddScore(22, mvaScores.at(1));
-  pidResults.AddScore(0, mvaScores.at(2));
+  for (size_t i = 0; i < mvaShowers.size(); i++) {
+    const float* scores(&mvaScores[i * bdt->NClasses()]);
 
-  if (!fMakeTree)
-    return pidResults;
+    MVAPID pidResults;
 
-  electronScore = mvaScores.at(0);
-  photonScore = mvaScores.at(1);
-  otherScore = mvaScores.at(2);
+    pidResults.AddScore(11, scores[0]);
+    pidResults.AddScore(22, scores[1]);
+    pidResults.AddScore(0, scores[2]);
 
-  bestScore = pidResults.BestScore();
-  bestPDG = pidResults.BestPDG();
+    mvaPIDVec.push_back(pidResults);
+    util::CreateAssn(*this, e, mvaPIDVec, mvaShowers[i], showerAssns);
+
+    // When making the tree the showers are scored one at a time
+    if (fMakeTree) {
+      electronScore = scores[0];
+      photonScore = scores[1];
+      otherScore = scores[2];
+
+      bestScore = pidResults.BestScore();
+      bestPDG = pidResults.BestPDG();
+    }
+  }
 
-  return pidResults;
+  mvaFeatures.Clear();
+  mvaShowers.clear();
 }
 
 std::map<size_t, art::Ptr<recob::PFParticle>> Razzle::GetPFPMap(std::vector<art::Ptr<recob::PFParticle>>& pfps) const
@@ -14,7 +14,7 @@
 
 #include <iostream>
 
-#include "art/Framework/Core/EDProducer.h"
+#include "art/Framework/Core/SharedProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -34,9 +34,9 @@
 namespace sbn {
   namespace evwgh {
 
-class SBNEventWeight : public art::EDProducer {
+class SBNEventWeight : public art::SharedProducer {
 public:
-  explicit SBNEventWeight(fhicl::ParameterSet const& p);
+  explicit SBNEventWeight(fhicl::ParameterSet const& p, art::ProcessingFrame const&);
 
   SBNEventWeight(SBNEventWeight const &) = delete;
   SBNEventWeight(SBNEventWeight &&) = delete;
@@ -44,8 +44,8 @@ public:
   SBNEventWeight& operator = (SBNEventWeight&&) = delete;
 
 private:
-  void produce(art::Event& e) override;
-  void beginRun(art::Run& run) override;
+  void produce(art::Event& e, art::ProcessingFrame const&) override;
+  void beginRun(art::Run& run, art::ProcessingFrame const&) override;
 
 private:
   WeightManager fWeightManager;
@@ -54,11 +54,17 @@ private:
 };
 
 
-SBNEventWeight::SBNEventWeight(fhicl::ParameterSet const& p)
-  : EDProducer{p},
+SBNEventWeight::SBNEventWeight(fhicl::ParameterSet const& p,
+                               art::ProcessingFrame const&)
+  : SharedProducer{p},
   fGenieModuleLabel(p.get<std::string>("generator_module_label", "generator")),
   fAllowMissingTruth(p.get<bool>("AllowMissingTruth"))
 {
+  // The calculators keep per-event state, so events are processed one
+  // at a time; the calculators of one event may still run concurrently
+  // (see the num_threads parameter of WeightManager)
+  serialize();
+
   const size_t n_func = fWeightManager.Configure(p, *this);
   if (n_func > 0) {
     produces<std::vector<sbn::evwgh::EventWeightMap> >();
@@ -68,7 +74,7 @@ SBNEventWeight::SBNEventWeight(fhicl::ParameterSet const& p)
 }
 
 
-void SBNEventWeight::produce(art::Event& e) {
+void SBNEventWeight::produce(art::Event& e, art::ProcessingFrame const&) {
   auto mcwghvec = std::make_unique<std::vector<EventWeightMap> >();
   auto wghassns = std::make_unique<art::Assns<simb::MCTruth, sbn::evwgh::EventWeightMap> >();
 
@@ -98,7 +104,7 @@ void SBNEventWeight::produce(art::Event& e) {
 }
 
 
-void SBNEventWeight::beginRun(art::Run& run) {
+void SBNEventWeight::beginRun(art::Run& run, art::ProcessingFrame const&) {
   auto p = std::make_unique<std::vector<EventWeightParameterSet> >();
   
   for (auto const& it : fWeightManager.GetWeightCalcMap()) {
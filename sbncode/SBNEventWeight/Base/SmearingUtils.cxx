@@ -148,6 +148,25 @@ std::vector<double> MultiGaussianSmearing(
   return smearedCentralValues;
 }
 
+
+void MultiGaussianSmearing(
+    std::vector<double> const& centralValue,
+    TMatrixD const& U,
+    float const* rand,
+    std::vector<double>& smearedCentralValue) {
+  smearedCentralValue.resize(centralValue.size());
+
+  for(unsigned int col = 0; col < centralValue.size(); ++col) {
+    // Find the weight of each col of the upper triangular cov. matrix
+    double weightFromU = 0;
+    for(size_t row=0; row<col+1; row++) {
+      weightFromU += U(row,col) * rand[row];
+    }
+
+    smearedCentralValue[col] = weightFromU + centralValue[col];
+  }
+}
+
   }  // namespace evwgh
 }  // namespace sbn
 
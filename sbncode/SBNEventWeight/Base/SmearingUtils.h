@@ -45,6 +45,22 @@ std::vector<double> MultiGaussianSmearing(
   bool isDecomposed,
   std::vector<float> rand);
 
+/**
+ * Apply Gaussian smearing to a set of central values with a single set of
+ * throws, without allocating.
+ *
+ * @param centralValue the values to be smeared
+ * @param U upper triangular Cholesky factor of the covariance matrix
+ *          (decomposed once by the caller)
+ * @param rand at least centralValue.size() standard normal throws
+ * @param smearedCentralValue filled with the smeared values
+ */
+void MultiGaussianSmearing(
+  std::vector<double> const& centralValue,
+  TMatrixD const& U,
+  float const* rand,
+  std::vector<double>& smearedCentralValue);
+
   }  // namespace evwgh
 }  // namespace sbn
 
@@ -26,6 +26,10 @@ public:
 
   virtual std::vector<float> GetWeight(art::Event& e, size_t inu) = 0;
 
+  /// Whether GetWeight may run concurrently with other calculators
+  /// (no shared global state, e.g. the GENIE singletons or gDirectory)
+  virtual bool IsThreadSafe() const { return false; }
+
   void SetName(std::string name) { fName = name; }
   void SetType(std::string type) { fType = type; }
 
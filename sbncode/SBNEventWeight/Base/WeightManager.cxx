@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <string>
 #include <vector>
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 #include "sbnobj/Common/SBNEventWeight/EventWeightMap.h"
 #include "WeightManager.h"
 
@@ -9,10 +12,40 @@ namespace sbn {
 EventWeightMap WeightManager::Run(art::Event& e, const int inu) {
   EventWeightMap mcwgh;
 
-  for (auto it=fWeightCalcMap.begin(); it!=fWeightCalcMap.end(); ++it) {
-    const std::vector<float>& weights = it->second->GetWeight(e, inu);
+  if (!fArena.is_active()) {
+    for (auto it=fWeightCalcMap.begin(); it!=fWeightCalcMap.end(); ++it) {
+      const std::vector<float>& weights = it->second->GetWeight(e, inu);
+      std::string wname = it->first + "_" + it->second->GetType();
+      mcwgh.insert({ wname, weights });
+    }
+    return mcwgh;
+  }
+
+  // Calculators with shared global state run serially first, then the thread
+  // safe ones are independent tasks, each writing to its own slot; the map is
+  // filled in the calculator map order
+  std::vector<WeightCalc*> calcs;
+  calcs.reserve(fWeightCalcMap.size());
+  for (auto const& it : fWeightCalcMap) calcs.push_back(it.second);
+
+  std::vector<std::vector<float> > weights(calcs.size());
+  std::vector<size_t> threadSafe;
+  for (size_t i = 0; i < calcs.size(); ++i) {
+    if (calcs[i]->IsThreadSafe()) threadSafe.push_back(i);
+    else weights[i] = calcs[i]->GetWeight(e, inu);
+  }
+
+  fArena.execute([&]() {
+    tbb::parallel_for(size_t(0), threadSafe.size(), [&](size_t j) {
+      size_t i = threadSafe[j];
+      weights[i] = calcs[i]->GetWeight(e, inu);
+    });
+  });
+
+  size_t i = 0;
+  for (auto it=fWeightCalcMap.begin(); it!=fWeightCalcMap.end(); ++it, ++i) {
     std::string wname = it->first + "_" + it->second->GetType();
-    mcwgh.insert({ wname, weights });
+    mcwgh.insert({ wname, std::move(weights[i]) });
   }
 
   return mcwgh;
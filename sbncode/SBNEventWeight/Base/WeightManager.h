@@ -9,11 +9,13 @@
  * Original author: Marco Del Tutto <marco.deltutto@physics.ox.ac.uk>
  */
 
+#include <algorithm>
 #include "art/Framework/Principal/fwd.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "nurandom/RandomUtils/NuRandomService.h"
 #include "lardataobj/Simulation/sim.h"
 #include "fhiclcpp/ParameterSet.h"
+#include "tbb/task_arena.h"
 #include "sbnobj/Common/SBNEventWeight/EventWeightMap.h"
 #include "WeightCalc.h"
 #include "WeightCalcFactory.h"
@@ -23,7 +25,7 @@ namespace sbn {
 
 class WeightManager {
 public:
-  WeightManager() {}
+  WeightManager() : fNumThreads(1) {}
   ~WeightManager() {}
 
   /**
@@ -31,6 +33,8 @@ public:
    *
    * 0) Looks at the weight_functions fcl parameter to get the name of the calculators   \n
    * 1) Creates the Calculators requested in step 0, and assigne a different random seed to each one \n
+   * 2) Reads num_threads, the number of calculators WeightManager::Run may evaluate concurrently, \n
+   *    and sets up the task arena they run in \n
    * 3) The future call WeightManager::Run will run the calculators           \n
    *
    * @param cfg the input parameters for settings
@@ -45,7 +49,12 @@ public:
    *
    * 0) Loos over all the previously emplaced calculators \n
    * 1) For each of them calculates the weights (more weight can be requested per calculator) \n
-   * 3) Returns a map from "calculator name" to vector of weights calculated which is available inside EventWeightMap
+   *    With num_threads > 1 the calculators flagged by WeightCalc::IsThreadSafe run \n
+   *    concurrently on a TBB task arena, after the others (e.g. GENIE) have run serially; \n
+   *    each one owns its random engine and reweighting objects, and a calculator is never \n
+   *    run by two threads at once \n
+   * 3) Returns a map from "calculator name" to vector of weights calculated which is available inside EventWeightMap \n
+   *    The map is filled in the same order whatever the number of threads
    *
    * @param e the art event
    * @param inu the index of the simulated neutrino in the event
@@ -59,6 +68,8 @@ public:
 
 private:
   std::map<std::string, WeightCalc*> fWeightCalcMap;  ///< A set of custom weight calculators
+  unsigned fNumThreads;  ///< Number of calculators that may run concurrently
+  tbb::task_arena fArena;  ///< Arena of the concurrent calculators, initialized in Configure
 };
 
 
@@ -69,6 +80,9 @@ size_t WeightManager::Configure(fhicl::ParameterSet const& p, Module& module) {
   // Get list of weight functions
   auto const rw_func = p.get<std::vector<std::string> >("weight_functions");
   auto const module_label = p.get<std::string>("module_label");
+  fNumThreads = p.get<unsigned>("num_threads", 1);
+  if (fNumThreads == 0)
+    throw cet::exception(__FUNCTION__) << "num_threads has to be at least 1" << std::endl;
 
   // Loop over all the functions and register them
   for (auto const& func : rw_func) {
@@ -92,6 +106,12 @@ size_t WeightManager::Configure(fhicl::ParameterSet const& p, Module& module) {
     fWeightCalcMap.emplace(func, wcalc);
   }
 
+  size_t nThreadSafe = 0;
+  for (auto const& it : fWeightCalcMap)
+    if (it.second->IsThreadSafe()) ++nThreadSafe;
+  if (fNumThreads > 1 && nThreadSafe > 1 && !fArena.is_active())
+    fArena.initialize(std::min<size_t>(fNumThreads, nThreadSafe));
+
   return fWeightCalcMap.size();
 }
 
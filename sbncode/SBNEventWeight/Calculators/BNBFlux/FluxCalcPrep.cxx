@@ -61,6 +61,7 @@ namespace sbn {
 
       if( CalcType == "Unisim"){//Unisim Calculator
 
+        fCalcType = kUnisim;
         std::string dataInput1  = pset.get< std::string >("CentralValue_hist_file");
         std::string cvfile_path  = sp.find_file(dataInput1);
         TFile fcv(Form("%s",cvfile_path.c_str()));
@@ -100,6 +101,7 @@ namespace sbn {
 
         if( CalcType == "PrimaryHadronNormalization" ){//k-
 
+          fCalcType = kPHNormalization;
           fParameterSet.Sample(engine);//Yes.. load it again;
 
         } else{//Other Hadron Calculators
@@ -111,6 +113,7 @@ namespace sbn {
           std::vector< std::string > pname; // these are keys to histograms
           if( CalcType == "PrimaryHadronFeynmanScaling" ){//k+
 
+            fCalcType = kPHFeynmanScaling;
             pname.push_back("FS/KPlus/FSKPlusFitVal");
             pname.push_back("FS/KPlus/FSKPlusFitCov");
 
@@ -120,6 +123,7 @@ namespace sbn {
             *(FitCov) *= fScalePos*fScalePos;
 
           }else if( CalcType == "PrimaryHadronSanfordWang" ){//k0
+            fCalcType = kPHSanfordWang;
             pname.push_back("SW/K0s/SWK0sFitVal");
             pname.push_back("SW/K0s/SWK0sFitCov");
             TArrayD* SWK0FitValArray = (TArrayD*) file->Get(pname[0].c_str());
@@ -130,6 +134,7 @@ namespace sbn {
 
           }else if( CalcType == "PrimaryHadronSWCentralSplineVariation" ){//pi+-
 
+            fCalcType = kPHSWCentralSplineVariation;
             std::string fitInput = pset.get< std::string >("ExternalFit");
             std::string HadronName; 
             std::string HadronAbriviation;
@@ -169,6 +174,16 @@ namespace sbn {
             TArrayD* HARPthetaBoundsArray = (TArrayD*) file->Get(pname[3].c_str());
             HARPthetaBounds = FluxWeightCalc::ConvertToVector(HARPthetaBoundsArray);
 
+            //The cross section matrix as a vector of analysis bins, see PHSWCSVWeightCalc()
+            int Ntbins = int(HARPthetaBounds.size()) - 1;
+            int Npbins = int(HARPmomentumBounds.size()) - 1;
+            fHARPXSecAnalysisBins.resize(Ntbins*Npbins);
+            for(int pbin = 0; pbin < Npbins; pbin++){
+              for(int tbin = 0; tbin < Ntbins; tbin++){
+                fHARPXSecAnalysisBins[pbin*Ntbins + tbin] = HARPXSec[0][pbin][tbin];
+              }
+            }
+
             /////////////////
             //
             //   Extract the Sanford-Wang Fit Parmeters
@@ -188,6 +203,20 @@ namespace sbn {
           }else  validC = false;//slightly incorrect calculator name in *fcl
 
           if(validC){//load random numbers based on FitCov
+            if(fIsDecomposed){
+              fFitCovU.ResizeTo(*FitCov);
+              fFitCovU = *FitCov;
+            } else {//decompose the FS/SW covariance once rather than for every universe
+              TDecompChol dc = TDecompChol(*FitCov);
+              if(!dc.Decompose()){
+                throw art::Exception(art::errors::StdException)
+                  << "Cannot decompose covariance matrix to begin smearing.";
+              }
+              fFitCovU.ResizeTo(FitCov->GetNrows(), FitCov->GetNcols());
+              fFitCovU = dc.GetU();
+            }
+            fThrowsPerUniverse = FitCov->GetNcols();
+
             //{2*multisim vector}
             //{{Ncols() elements}} <-- feed these amount everytime;
             for( int index = 1; index < 2*(FitCov->GetNcols()); index ++){
@@ -203,7 +232,14 @@ namespace sbn {
 
         }//end of special Hadron calculator configurations
 
-      } else  validC = false; //the calculator name is way too off.
+      } else {//the calculator name is way too off.
+        throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": "
+          <<" calculator "+CalcType + " is invalid"
+          <<std::endl;
+      }
+
+      //keep a private copy of the throws so the universe loops only index into it
+      if(!fParameterSet.fParameterMap.empty()) fThrows = (fParameterSet.fParameterMap.begin())->second;
 //      std::cout<<"SBNEventWeight : finish configuration."<<std::endl;
     }//End of Configure() function
 
@@ -228,7 +264,7 @@ namespace sbn {
 
       //Iterate through each neutrino in the event
     std::cout<<"SBNEventWeight Flux: Get calculator "<<CalcType<<std::endl;
-      if( CalcType == "Unisim"){//Unisim Calculator
+      if( fCalcType == kUnisim){//Unisim Calculator
         weights.resize(NUni);
         //Unisim specific
         //containers for the parent and neutrino type information
@@ -264,22 +300,9 @@ namespace sbn {
         if(fParameterSet.fRWType == EventWeightParameterSet::kMultisim){
 
           for (size_t i=0;i<weights.size();i++) {
-            double randomN = (fParameterSet.fParameterMap.begin())->second[i];
+            double randomN = *UniverseThrows(i);
             weights[i]=UnisimWeightCalc(enu, ptype, ntype, randomN , PosOnly);//AddParameter result does not work here;
-
-      if(count_weights){
-        if(weights[i]<0){
-          wcn++;
-        }else if((weights[i]-0)<1e-30){
-          wc0++;
-        }else if(fabs(weights[i]-30) < 1e-30){
-          wc30++;
-        } else if(fabs(weights[i]-1)<1e-30){
-          wc1++;
-        } else {
-          wc++;
-        }
-      }
+            if(count_weights) CountWeight(weights[i]);
           }//Iterate through the number of universes      
         }
       } else{//then this must be PrimaryHadron
@@ -295,49 +318,27 @@ namespace sbn {
 
         if(fParameterSet.fRWType == EventWeightParameterSet::kMultisim){
 
-          for (unsigned int i = 0; int(weights.size()) < NUni; i++) {//if all weights are 1, no need to calculate weights;
-            std::pair<bool, double> test_weight;
-
-            std::vector< float > Vrandom = (fParameterSet.fParameterMap.begin())->second;//vector of random #
-            std::vector< float > subVrandom;//sub-vector of random numbers;
-            if( CalcType == "PrimaryHadronNormalization"){//Normalization
-              test_weight = PHNWeightCalc(fluxlist[inu], Vrandom[i]);
-
-            } else {
-              subVrandom = {Vrandom.begin()+i*FitCov->GetNcols(), Vrandom.begin()+(i+1)*FitCov->GetNcols()};
-              if( CalcType == "PrimaryHadronFeynmanScaling"){//FeynmanScaling
-                test_weight = PHFSWeightCalc(fluxlist[inu], subVrandom);
-
-              } else if( CalcType == "PrimaryHadronSanfordWang"){//SanfordWang
-                test_weight = PHSWWeightCalc(fluxlist[inu], subVrandom);
-
-              } else if( CalcType == "PrimaryHadronSWCentralSplineVariation"){//SWCentaralSplineVariation
-                test_weight = PHSWCSVWeightCalc(fluxlist[inu], subVrandom);
-
-              } else throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": this shouldnt happen.."<<std::endl;
-            }
-
-            if(test_weight.first){  
-              weights.push_back(test_weight.second);
-              double tmp_weight = test_weight.second;
-//              std::cout<<i<<" ("<<tmp_weight<<") ";
-        if(count_weights){
-          if(tmp_weight<0){
-            wcn++;
-          }else if((tmp_weight-0)<1e-30){
-            wc0++;
-          }else if(fabs(tmp_weight-30) < 1e-30){
-            wc30++;
-          } else if(fabs(tmp_weight-1)<1e-30){
-            wc1++;
-          } else {
-            wc++;
+          weights.reserve(NUni);
+          switch(fCalcType){
+            case kPHNormalization:
+              PHNWeightCalc(fluxlist[inu], NUni, weights);
+              break;
+            case kPHFeynmanScaling:
+              PHFSWeightCalc(fluxlist[inu], NUni, weights);
+              break;
+            case kPHSanfordWang:
+              PHSWWeightCalc(fluxlist[inu], NUni, weights);
+              break;
+            case kPHSWCentralSplineVariation:
+              PHSWCSVWeightCalc(fluxlist[inu], NUni, weights);
+              break;
+            default:
+              throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": this shouldnt happen.."<<std::endl;
           }
-        }
-
-            };
 
-          }//Iterate through the number of universes      
+          if(count_weights){
+            for(float w : weights) CountWeight(w);
+          }
         }//Yes, Multisim
       }
 
@@ -351,6 +352,31 @@ namespace sbn {
     }//GetWeight()
 
 
+    float const* FluxWeightCalc::UniverseThrows(size_t i) const {
+      if((i+1)*fThrowsPerUniverse > fThrows.size()){
+        throw cet::exception(__PRETTY_FUNCTION__) << GetName() << ": "
+          << "ran out of random throws at universe " << i
+          << " (" << fThrows.size() << " throws loaded)" << std::endl;
+      }
+      return fThrows.data() + i*fThrowsPerUniverse;
+    }
+
+
+    void FluxWeightCalc::CountWeight(double weight) {
+      if(weight<0){
+        wcn++;
+      }else if((weight-0)<1e-30){
+        wc0++;
+      }else if(fabs(weight-30) < 1e-30){
+        wc30++;
+      } else if(fabs(weight-1)<1e-30){
+        wc1++;
+      } else {
+        wc++;
+      }
+    }
+
+
     std::vector<double> FluxWeightCalc::ConvertToVector(TArrayD const* array) {
       std::vector<double> v(array->GetSize());
       std::copy(array->GetArray(), array->GetArray() + array->GetSize(),
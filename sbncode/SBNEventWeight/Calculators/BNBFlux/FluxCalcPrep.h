@@ -33,6 +33,10 @@ namespace sbn {
         //inu - the ith parameter.
         std::vector<float> GetWeight(art::Event& e, size_t inu) override;
 
+        //Each calculator owns its throws and histogram values; the spline
+        //  variation builds a TH1F per call, which registers in gDirectory
+        bool IsThreadSafe() const override { return fCalcType != kPHSWCentralSplineVariation; }
+
         //UnisimWeightCalc() - Function for evaluating a specific weight
         //enu - neutrino energy from simb::MCTruth; 
         //ptype-  parent particles label: pi, k, k0, mu from simb:MCFlux
@@ -42,10 +46,15 @@ namespace sbn {
 
         //4 *WeightCalc() functions
         double UnisimWeightCalc(double enu, int ptype, int ntype, double randomN, bool noNeg);//Unisim
-        std::pair<bool, double> PHNWeightCalc  (simb::MCFlux flux, float rand);//PrimaryHadronNormalizationWeightCalc
-        std::pair<bool, double> PHFSWeightCalc  (simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronFeynmanScaling
-        std::pair<bool, double> PHSWWeightCalc  (simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronSanfordWangWeightCalc
-        std::pair<bool, double> PHSWCSVWeightCalc(simb::MCFlux flux, std::vector<float> rand);//PrimaryHadronSWCentralSplineVariationWeightCalc
+
+        //PrimaryHadron calculators evaluate all the universes of one flux entry in one call:
+        //  the flux dependent terms are computed once, then the throws of universe 0, 1, ...
+        //  are used in turn; universes with unphysical parameters are skipped
+        //  until NUni weights are appended to weights.
+        void PHNWeightCalc    (simb::MCFlux const& flux, int NUni, std::vector<float>& weights);//PrimaryHadronNormalizationWeightCalc
+        void PHFSWeightCalc   (simb::MCFlux const& flux, int NUni, std::vector<float>& weights);//PrimaryHadronFeynmanScaling
+        void PHSWWeightCalc   (simb::MCFlux const& flux, int NUni, std::vector<float>& weights);//PrimaryHadronSanfordWangWeightCalc
+        void PHSWCSVWeightCalc(simb::MCFlux const& flux, int NUni, std::vector<float>& weights);//PrimaryHadronSWCentralSplineVariationWeightCalc
         
         //Handy tool
         std::vector<double> ConvertToVector(TArrayD const* array);
@@ -55,6 +64,22 @@ namespace sbn {
         std::string fGeneratorModuleLabel;
         std::string CalcType;
 
+        //calc_type, resolved once in Configure()
+        enum CalcType_t {
+          kUnisim,
+          kPHNormalization,
+          kPHFeynmanScaling,
+          kPHSanfordWang,
+          kPHSWCentralSplineVariation
+        };
+        CalcType_t fCalcType{kUnisim};
+
+        //Random throws of the first parameter, universe-major:
+        //  universe i uses fThrows[i*fThrowsPerUniverse, (i+1)*fThrowsPerUniverse)
+        std::vector<float> fThrows;
+        size_t fThrowsPerUniverse{1};
+        float const* UniverseThrows(size_t i) const;
+
         double fScalePos{}; 
         double fScaleNeg = 1; //for Unisim
 
@@ -70,6 +95,7 @@ namespace sbn {
         //-- FeynmanScaling
         std::vector<double> FitVal{};//Shared to SanfordWang
         TMatrixD* FitCov{nullptr};//Shared to SanfordWang
+        TMatrixD fFitCovU;//Upper triangular Cholesky factor of the covariance, shared by FS/SW/SWCSV
 
         //-- SWCentaralSplineVariation
         TMatrixD* HARPXSec{nullptr};
@@ -77,8 +103,10 @@ namespace sbn {
         std::vector<double> HARPthetaBounds{};
         std::vector<double> SWParam{};
         bool fIsDecomposed{false};
+        std::vector<double> fHARPXSecAnalysisBins{};//HARPXSec in analysis bins: momentum[theta[]]
 
         //Weight Counter
+        void CountWeight(double weight);
         int wc = 0;
         int wcn = 0;
         int wc0 = 0;
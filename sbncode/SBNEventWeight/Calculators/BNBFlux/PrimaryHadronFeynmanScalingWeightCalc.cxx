@@ -6,7 +6,7 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHFSWeightCalc(simb::MCFlux flux, std::vector<float> rand){
+    void FluxWeightCalc::PHFSWeightCalc(simb::MCFlux const& flux, int NUni, std::vector<float>& weights){
 
       // 
       //  Largely built off the MiniBooNE code 
@@ -18,9 +18,6 @@ namespace sbn {
       //  JZ (6/2017) : Fixed typo in the E_cm calculation per Mike S. suggestions 
       //   
 
-      // We need to guard against unphysical parameters 
-      bool parameters_pass = false;
-
       // Get Neutrino Parent Kinimatics       
       double HadronMass = 0.4937;
 
@@ -104,60 +101,65 @@ namespace sbn {
 
       if(CV < 0) CV = 0;
       if(fabs(xF) > 1) CV = 0;
-      // Define the variations around that cross section
-      //    To do this we will call the a function from WeightCalc
-      //    that will generate a set of smeared parameters based 
-      //    on the covariance matrix that we imported
-      std::vector< double > FSKPlusFitSmeared = MultiGaussianSmearing(FitVal, FitCov, rand);//Defined in sbncode/SBNEventWeight/Base/SmearingUtils.h
-
-      // Pull out the parameters for the Feynman Scaling 
-      double smeared_c1 = FSKPlusFitSmeared.at(0);     
-      double smeared_c2 = FSKPlusFitSmeared.at(1);     
-      double smeared_c3 = FSKPlusFitSmeared.at(2);     
-      double smeared_c4 = FSKPlusFitSmeared.at(3);     
-      double smeared_c5 = FSKPlusFitSmeared.at(4);     
-      double smeared_c6 = FSKPlusFitSmeared.at(5);     
-      double smeared_c7 = FSKPlusFitSmeared.at(6);     
-
-      if(smeared_c1 > 0 && 
-          smeared_c2 > 0 && 
-          smeared_c3 > 0 && 
-          smeared_c5 > 0 && 
-          smeared_c7 > 0){
-        parameters_pass = true;  
-      }
-
-      double RW = smeared_c1*(HadronVec.P()*HadronVec.P()/HadronE)*exp(-1.*smeared_c3*pow(fabs(xF),smeared_c4) 
-          - smeared_c7*pow(fabs(HadronPT*xF),smeared_c6)
-          - smeared_c2*HadronPT
-          - smeared_c5*HadronPT*HadronPT);
-
-      if(RW < 0) RW = 0;
-      if(fabs(xF) > 1) RW = 0;
-
-      double weight = 1; 
 
-      if(RW < 0 || CV < 0){
-        weight = 1;
+      // The flux dependent terms above are shared by all the universes
+      std::vector< double > FSKPlusFitSmeared;
+      for(size_t i = 0; int(weights.size()) < NUni; i++){
+
+        // Define the variations around that cross section
+        //    To do this we will call the a function from WeightCalc
+        //    that will generate a set of smeared parameters based 
+        //    on the covariance matrix that we imported
+        MultiGaussianSmearing(FitVal, fFitCovU, UniverseThrows(i), FSKPlusFitSmeared);//Defined in sbncode/SBNEventWeight/Base/SmearingUtils.h
+
+        // Pull out the parameters for the Feynman Scaling 
+        double smeared_c1 = FSKPlusFitSmeared.at(0);     
+        double smeared_c2 = FSKPlusFitSmeared.at(1);     
+        double smeared_c3 = FSKPlusFitSmeared.at(2);     
+        double smeared_c4 = FSKPlusFitSmeared.at(3);     
+        double smeared_c5 = FSKPlusFitSmeared.at(4);     
+        double smeared_c6 = FSKPlusFitSmeared.at(5);     
+        double smeared_c7 = FSKPlusFitSmeared.at(6);     
+
+        // We need to guard against unphysical parameters 
+        bool parameters_pass = false;
+        if(smeared_c1 > 0 && 
+            smeared_c2 > 0 && 
+            smeared_c3 > 0 && 
+            smeared_c5 > 0 && 
+            smeared_c7 > 0){
+          parameters_pass = true;  
+        }
+
+        double RW = smeared_c1*(HadronVec.P()*HadronVec.P()/HadronE)*exp(-1.*smeared_c3*pow(fabs(xF),smeared_c4) 
+            - smeared_c7*pow(fabs(HadronPT*xF),smeared_c6)
+            - smeared_c2*HadronPT
+            - smeared_c5*HadronPT*HadronPT);
+
+        if(RW < 0) RW = 0;
+        if(fabs(xF) > 1) RW = 0;
+
+        double weight = 1; 
+
+        if(RW < 0 || CV < 0){
+          weight = 1;
+        }
+        else if(CV < 1.e-12){
+          weight = 1;
+        }
+        else{
+          weight *= RW/CV;
+        }
+
+        if(weight < 0) weight = 0;
+        if(weight > 30) weight = 30;
+        if(!(std::isfinite(weight))){
+          std::cout << "FS : Failed to get a finite weight" << std::endl; 
+          weight = 30;}
+
+        if(parameters_pass) weights.push_back(weight);
       }
-      else if(CV < 1.e-12){
-        weight = 1;
-      }
-      else{
-        weight *= RW/CV;
-      }
-
-      if(weight < 0) weight = 0;
-      if(weight > 30) weight = 30;
-      if(!(std::isfinite(weight))){
-        std::cout << "FS : Failed to get a finite weight" << std::endl; 
-        weight = 30;}
-
-      std::pair<bool, double> output(parameters_pass, weight);
-
-
 
-      return output; 
 
     }
 
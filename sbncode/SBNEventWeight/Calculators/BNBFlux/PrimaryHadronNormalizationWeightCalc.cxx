@@ -6,18 +6,16 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHNWeightCalc(simb::MCFlux flux, float rand){
-      // We need to guard against unphysical parameters 
-      bool parameters_pass = false;
+    void FluxWeightCalc::PHNWeightCalc(simb::MCFlux const& flux, int NUni, std::vector<float>& weights){
 
-      double weight = rand+1;
+      for(size_t i = 0; int(weights.size()) < NUni; i++){
+        float rand = *UniverseThrows(i);
 
-      if(weight > 0) parameters_pass = true;
-      else{parameters_pass = false;}
+        double weight = rand+1;
 
-      std::pair<bool, double> output(parameters_pass, weight);
-
-      return output; 
+        // We need to guard against unphysical parameters 
+        if(weight > 0) weights.push_back(weight);
+      }
 
     }
 
@@ -7,7 +7,7 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHSWCSVWeightCalc(simb::MCFlux flux, std::vector<float> rand){
+    void FluxWeightCalc::PHSWCSVWeightCalc(simb::MCFlux const& flux, int NUni, std::vector<float>& weights){
 
       // 
       //  Largely built off the MiniBooNE code 
@@ -19,8 +19,6 @@ namespace sbn {
       //  JZ (6/2017) : Changed guards on c9 to be double point precision 
       //   
 
-      bool parameters_pass = true;
-
       double c1 = SWParam[0];
       double c2 = SWParam[1];
       double c3 = SWParam[2];
@@ -126,65 +124,14 @@ namespace sbn {
       //      analysis bin 0 is the zeroth theta and zeroth momentum bin
       //  but analysis bin 27 is the 3rd theta and 5th momentum bin
       // 
-      // The first thing to do is convert our cross section matrix into 
-      // an std::vector for the analysis bins
-      //
-      std::vector< double > HARPCrossSectionAnalysisBins;
-      HARPCrossSectionAnalysisBins.resize(int(Ntbins*Npbins));
-
-      int anaBin = 0;
-      for(int pbin = 0; pbin < Npbins; pbin++){
-        for(int tbin = 0; tbin < Ntbins; tbin++){  
-          HARPCrossSectionAnalysisBins[anaBin] = HARPXSec[0][pbin][tbin];
-          anaBin++;
-        }
-      }
-
-      //
-      // Now using this we can vary the cross section based on the HARP covariance matrix 
-      // this will allow us to reweigh each cross section measurement based on
-      // the multigaussian smearing of this matrix. 
-      //
-
-      std::vector< double > smearedHARPCrossSectionAnalysisBins = 
-        MultiGaussianSmearing(HARPCrossSectionAnalysisBins, FitCov, fIsDecomposed,rand); 
-      HARPCrossSectionAnalysisBins.clear();
-
+      // The cross section matrix was converted into an std::vector 
+      // for the analysis bins at configuration (fHARPXSecAnalysisBins)
       //
-      //   Check all the smeared cross sections, if any come out to be negative then 
-      //   we will not pass this given parameter set.
-      //
-
-      for(int check = 0; check < int(smearedHARPCrossSectionAnalysisBins.size()); check++){
-        if(smearedHARPCrossSectionAnalysisBins[check] < 0){ parameters_pass = false;}
-      }
-
-      //  
-      // With a checked set of smeared cross sections we can convert our analysis bin
-      // std::vector back into a TMatrixD, though this is a bit annoying since TMatrices 
-      // are an annoying format. 
-      //
-      TMatrixD*  smearedHARPXSec = new TMatrixD(Npbins,Ntbins);
-
-      anaBin = 0;
-      for(int pbin = 0; pbin < Npbins; pbin++){
-        for(int tbin = 0; tbin < Ntbins; tbin++){
-          smearedHARPXSec[0][pbin][tbin] = smearedHARPCrossSectionAnalysisBins[anaBin];    
-          anaBin++;
-        }
-      }
 
       //
-      // We want to now make a vector of histograms that are 
-      //  projections across the cross section matrix, 
-      //  this means we want to have vectors where one histogram 
-      //  is made for each bin on variable X where the histogram
-      //  then contains bins for variable Y. 
-      //
-      //  This will allow us to do a 2D interpolation across the
-      //  full parameter space using cubic spline fits 
+      // The momentum and theta histograms used for the splines only need
+      // their contents updated, so they are made once for all the universes
       //
-
       std::vector< TH1F > MomentumBins;
       MomentumBins.resize(Ntbins);
       for(int bin = 0; bin < Ntbins; bin++){
@@ -192,111 +139,142 @@ namespace sbn {
         MomentumBins[bin].SetBit(kCanDelete);
       } 
 
+      TH1F ThetaBins("HARPt",";;;", Ntbins, HARPthetaBins);
+      ThetaBins.SetBit(kCanDelete);
+
       //Setup vectors of splines for fitting
       std::vector< TSpline3 > SplinesVsMomentum; 
       SplinesVsMomentum.resize(Ntbins);
 
-      for(int tbin = 0; tbin < Ntbins; tbin++){
-        for(int pbin = 0; pbin < Npbins; pbin++){
+      std::vector< double > smearedHARPCrossSectionAnalysisBins;
 
-          //
-          // We want to create spline at fixed theta values, that way we can 
-          // study the cross section at the given meson momentum
-          MomentumBins[tbin].SetBinContent(pbin+1, smearedHARPXSec[0][pbin][tbin]);        
-          // This will give us the cross section in discreet slices of theta (tbin)
-          // but each histogram in the vector will be the cross section in bins of
-          // momentum that can then be cublic splined  
-          //
-        }
+      // The flux dependent terms above are shared by all the universes
+      for(size_t i = 0; int(weights.size()) < NUni; i++){
+
+        bool parameters_pass = true;
 
         //
-        // in a given theta slice we can now spline over the cross section entries
-        // in bins of momentum
+        // Now using this we can vary the cross section based on the HARP covariance matrix 
+        // this will allow us to reweigh each cross section measurement based on
+        // the multigaussian smearing of this matrix. 
         //
-        // Important note about Splines, MiniBooNE used constraints on the
-        // second derivative of the first and final knot point and required 
-        // that they both equal to zero, this is not naturally the case in 
-        // in TSpline3 but it is default in DCSPLC (the Fortran CERN library spline function)
-        // this helps to control the smoothness of the spline and minimizes the variation bin to bin
-        // For TSpine3 this is controlled by:
+
+        MultiGaussianSmearing(fHARPXSecAnalysisBins, fFitCovU, UniverseThrows(i), smearedHARPCrossSectionAnalysisBins); 
+
+        //
+        //   Check all the smeared cross sections, if any come out to be negative then 
+        //   we will not pass this given parameter set.
+        //
+
+        for(int check = 0; check < int(smearedHARPCrossSectionAnalysisBins.size()); check++){
+          if(smearedHARPCrossSectionAnalysisBins[check] < 0){ parameters_pass = false;}
+        }
+
         //
-        //  b1 = constrain first knot 1st derivative 
-        //  b2 = constrain first knot 2nd derivative 
-        //  e1 = constrain final knot 1st derivative 
-        //  e2 = constrain final knot 2nd derivative 
+        // We want to now make a vector of histograms that are 
+        //  projections across the cross section matrix, 
+        //  this means we want to have vectors where one histogram 
+        //  is made for each bin on variable X where the histogram
+        //  then contains bins for variable Y. 
         //
-        //  the numbers that follow are the values you constrain those conditions to
+        //  This will allow us to do a 2D interpolation across the
+        //  full parameter space using cubic spline fits 
         //
-        SplinesVsMomentum[tbin] = TSpline3(&(MomentumBins[tbin]),"b2e2",0,0); 
 
-      }
-      MomentumBins.clear();
-      delete smearedHARPXSec;
-      //
-      // Now that we have the 1D Splines over momentum we want to know
-      // what the cross section is for the meson's momentum in bins of
-      // theta that way we can extract the cross section at the meson's
-      // theta. 
-      //
-      TH1F* ThetaBins = new TH1F("HARPt",";;;", Ntbins, HARPthetaBins);
-      ThetaBins->SetBit(kCanDelete);
-      for(int tbin = 0; tbin < Ntbins; tbin++){
-        ThetaBins->SetBinContent(tbin+1, SplinesVsMomentum[tbin].Eval(HadronVec.P()));
-      } 
+        for(int tbin = 0; tbin < Ntbins; tbin++){
+          for(int pbin = 0; pbin < Npbins; pbin++){
+
+            //
+            // We want to create spline at fixed theta values, that way we can 
+            // study the cross section at the given meson momentum
+            MomentumBins[tbin].SetBinContent(pbin+1, smearedHARPCrossSectionAnalysisBins[pbin*Ntbins + tbin]);        
+            // This will give us the cross section in discreet slices of theta (tbin)
+            // but each histogram in the vector will be the cross section in bins of
+            // momentum that can then be cublic splined  
+            //
+          }
 
-      ////      
-      // Now we can spline across the theta bins and we can extract the exact value of the 
-      // cross section for the meson's theta value
-      //
-      //  Options described above.
-      /////
+          //
+          // in a given theta slice we can now spline over the cross section entries
+          // in bins of momentum
+          //
+          // Important note about Splines, MiniBooNE used constraints on the
+          // second derivative of the first and final knot point and required 
+          // that they both equal to zero, this is not naturally the case in 
+          // in TSpline3 but it is default in DCSPLC (the Fortran CERN library spline function)
+          // this helps to control the smoothness of the spline and minimizes the variation bin to bin
+          // For TSpine3 this is controlled by:
+          //
+          //  b1 = constrain first knot 1st derivative 
+          //  b2 = constrain first knot 2nd derivative 
+          //  e1 = constrain final knot 1st derivative 
+          //  e2 = constrain final knot 2nd derivative 
+          //
+          //  the numbers that follow are the values you constrain those conditions to
+          //
+          SplinesVsMomentum[tbin] = TSpline3(&(MomentumBins[tbin]),"b2e2",0,0); 
 
-      TSpline3* FinalSpline = new TSpline3(ThetaBins,"b2e2",0,0);
+        }
+        //
+        // Now that we have the 1D Splines over momentum we want to know
+        // what the cross section is for the meson's momentum in bins of
+        // theta that way we can extract the cross section at the meson's
+        // theta. 
+        //
+        for(int tbin = 0; tbin < Ntbins; tbin++){
+          ThetaBins.SetBinContent(tbin+1, SplinesVsMomentum[tbin].Eval(HadronVec.P()));
+        } 
 
-      double RW = FinalSpline->Eval(ThetaOfInterest);
+        ////      
+        // Now we can spline across the theta bins and we can extract the exact value of the 
+        // cross section for the meson's theta value
+        //
+        //  Options described above.
+        /////
 
-      SplinesVsMomentum.clear();
-      delete ThetaBins;
-      delete FinalSpline;
+        TSpline3 FinalSpline(&ThetaBins,"b2e2",0,0);
 
-      //
-      // These guards are inherited from MiniBooNE code
-      //
-      // These were defined here: 
-      // 
-      //   cdcvs0.fnal.gov/cgi-bin/public-cvs/cvsweb-public.cgi/~checkout~/ ... 
-      //              miniboone/AnalysisFramework/MultisimMatrix/src/MultisimMatrix.inc    
-      //
-      //  This forces any negative spline fit to be 1     
+        double RW = FinalSpline.Eval(ThetaOfInterest);
 
-      ////////
-      //  Possible Bug.
-      ////////     
-      // This seems to be a feature in the MiniBooNE code
-      //  It looks like the intension is to set this to zero
-      //  but it is set to 1 before it is set to zero  
+        //
+        // These guards are inherited from MiniBooNE code
+        //
+        // These were defined here: 
+        // 
+        //   cdcvs0.fnal.gov/cgi-bin/public-cvs/cvsweb-public.cgi/~checkout~/ ... 
+        //              miniboone/AnalysisFramework/MultisimMatrix/src/MultisimMatrix.inc    
+        //
+        //  This forces any negative spline fit to be 1     
 
-      double weight = 1; 
+        ////////
+        //  Possible Bug.
+        ////////     
+        // This seems to be a feature in the MiniBooNE code
+        //  It looks like the intension is to set this to zero
+        //  but it is set to 1 before it is set to zero  
 
-      if(RW < 0 || CV < 0){
-        weight = 1;
-      }
-      else if(fabs(CV) < 1.e-12){
-        weight = 1;
-      }
-      else{
-        weight *= RW/CV;
-      }
+        double weight = 1; 
+
+        if(RW < 0 || CV < 0){
+          weight = 1;
+        }
+        else if(fabs(CV) < 1.e-12){
+          weight = 1;
+        }
+        else{
+          weight *= RW/CV;
+        }
+
+        if(weight < 0) weight = 0; 
+        if(weight > 30) weight = 30; 
+        if(!(std::isfinite(weight))){
+          std::cout << "SW+Splines : Failed to get a finite weight" << std::endl;   
+          weight = 30;
+        }
 
-      if(weight < 0) weight = 0; 
-      if(weight > 30) weight = 30; 
-      if(!(std::isfinite(weight))){
-        std::cout << "SW+Splines : Failed to get a finite weight" << std::endl;   
-        weight = 30;
+        if(parameters_pass) weights.push_back(weight);
       }
 
-      std::pair<bool, double> output(parameters_pass, weight);
-      return output; 
 
     }// Done with the WeigthCalc function
 
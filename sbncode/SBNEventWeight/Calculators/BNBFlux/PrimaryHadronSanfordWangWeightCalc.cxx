@@ -6,7 +6,7 @@
 namespace sbn {
   namespace evwgh {
 
-    std::pair<bool, double> FluxWeightCalc::PHSWWeightCalc(simb::MCFlux flux, std::vector<float> rand){
+    void FluxWeightCalc::PHSWWeightCalc(simb::MCFlux const& flux, int NUni, std::vector<float>& weights){
 
       // 
       //  Largely built off the MiniBooNE code 
@@ -18,9 +18,6 @@ namespace sbn {
       //  JZ (6/2017) : Changed guards on c9 to be double point precision 
       //   
 
-      // We need to guard against unphysical parameters 
-      bool parameters_pass = true;
-
       // Get Neutrino Parent Kinimatics       
       double HadronMass = 0.4976;
 
@@ -85,62 +82,69 @@ namespace sbn {
         CV = 0;
       } 
 
-      // Define the variations around that cross section
-      //    To do this we will call the a function from WeightCalc
-      //    that will generate a set of smeared parameters based 
-      //    on the covariance matrix that we imported
-      std::vector< double > SWK0FitSmeared = MultiGaussianSmearing(FitVal, FitCov, rand);       
-
-      // Pull out the smeared parameters for the Sanford-Wang Fit
-      double smeared_c1 = SWK0FitSmeared.at(0);     
-      double smeared_c2 = SWK0FitSmeared.at(1);     
-      double smeared_c3 = SWK0FitSmeared.at(2);     
-      double smeared_c4 = SWK0FitSmeared.at(3);     
-      double smeared_c5 = SWK0FitSmeared.at(4);     
-      double smeared_c6 = SWK0FitSmeared.at(5);     
-      double smeared_c7 = SWK0FitSmeared.at(6);     
-      double smeared_c8 = SWK0FitSmeared.at(7);     
-      double smeared_c9 = SWK0FitSmeared.at(8);     
-
-      /// Perform the MiniBooNE 
-      if(smeared_c1 < 0 || 
-          smeared_c3 < 0 || 
-          smeared_c6 < 0){
-        parameters_pass = false;  
+      // The flux dependent terms above are shared by all the universes
+      std::vector< double > SWK0FitSmeared;
+      for(size_t i = 0; int(weights.size()) < NUni; i++){
+
+        // Define the variations around that cross section
+        //    To do this we will call the a function from WeightCalc
+        //    that will generate a set of smeared parameters based 
+        //    on the covariance matrix that we imported
+        MultiGaussianSmearing(FitVal, fFitCovU, UniverseThrows(i), SWK0FitSmeared);
+
+        // Pull out the smeared parameters for the Sanford-Wang Fit
+        double smeared_c1 = SWK0FitSmeared.at(0);     
+        double smeared_c2 = SWK0FitSmeared.at(1);     
+        double smeared_c3 = SWK0FitSmeared.at(2);     
+        double smeared_c4 = SWK0FitSmeared.at(3);     
+        double smeared_c5 = SWK0FitSmeared.at(4);     
+        double smeared_c6 = SWK0FitSmeared.at(5);     
+        double smeared_c7 = SWK0FitSmeared.at(6);     
+        double smeared_c8 = SWK0FitSmeared.at(7);     
+        double smeared_c9 = SWK0FitSmeared.at(8);     
+
+        // We need to guard against unphysical parameters 
+        bool parameters_pass = true;
+
+        /// Perform the MiniBooNE 
+        if(smeared_c1 < 0 || 
+            smeared_c3 < 0 || 
+            smeared_c6 < 0){
+          parameters_pass = false;  
+        }
+
+        double RW = smeared_c1 * pow(HadronVec.P(), smeared_c2) * 
+          (1. - HadronVec.P()/(ProtonVec.P() - smeared_c9)) *
+          exp(-1. * smeared_c3 * pow(HadronVec.P(), smeared_c4) / pow(ProtonVec.P(), smeared_c5)) *
+          exp(-1. * smeared_c6 * HadronVec.Theta() *(HadronVec.P() - smeared_c7 * ProtonVec.P() * pow(cos(HadronVec.Theta()), smeared_c8)));
+
+        // Check taken from MiniBooNE code
+        if((HadronVec.P()) > ((ProtonVec.P()) - (smeared_c9))){
+          RW = 0;
+        } 
+
+        double weight = 1; 
+
+        if(RW < 0 || CV < 0){//dont bother this; if this happens, the weight would be skipped...
+          weight = 1;
+        }
+        else if(fabs(CV) < 1.e-12){
+          weight = 1;
+        }
+        else{
+          weight *= RW/CV;
+        }
+
+        if(weight < 0) weight = 0; 
+        if(weight > 30) weight = 30; 
+        if(!(std::isfinite(weight))){
+          std::cout << "SW : Failed to get a finite weight" << std::endl;      
+          weight = 30;
+        }
+
+        if(parameters_pass) weights.push_back(weight);
       }
 
-      double RW = smeared_c1 * pow(HadronVec.P(), smeared_c2) * 
-        (1. - HadronVec.P()/(ProtonVec.P() - smeared_c9)) *
-        exp(-1. * smeared_c3 * pow(HadronVec.P(), smeared_c4) / pow(ProtonVec.P(), smeared_c5)) *
-        exp(-1. * smeared_c6 * HadronVec.Theta() *(HadronVec.P() - smeared_c7 * ProtonVec.P() * pow(cos(HadronVec.Theta()), smeared_c8)));
-
-      // Check taken from MiniBooNE code
-      if((HadronVec.P()) > ((ProtonVec.P()) - (smeared_c9))){
-        RW = 0;
-      } 
-
-      double weight = 1; 
-
-      if(RW < 0 || CV < 0){//dont bother this; if this happens, the weight would be skipped...
-        weight = 1;
-      }
-      else if(fabs(CV) < 1.e-12){
-        weight = 1;
-      }
-      else{
-        weight *= RW/CV;
-      }
-
-      if(weight < 0) weight = 0; 
-      if(weight > 30) weight = 30; 
-      if(!(std::isfinite(weight))){
-        std::cout << "SW : Failed to get a finite weight" << std::endl;      
-        weight = 30;
-      }
-
-      std::pair<bool, double> output(parameters_pass, weight);
-
-      return output; 
 
 
     }
@@ -238,6 +238,16 @@ public:
 private:
   std::vector< genie::rew::GReWeight > reweightVector;
 
+  // Knob values of every universe, and whether the universe tweaks
+  // MaCCQE (strange-CCQE events then get a unit weight)
+  std::vector< std::vector< std::pair<genie::rew::GSyst_t, double> > > fUniverseKnobs;
+  std::vector< bool > fUniverseIncludesMaCCQE;
+
+  // Evaluate all universes with a single GReWeight, re-tuned per universe,
+  // instead of one GReWeight (with all its weight calculators) per universe
+  bool fSingleReweight;
+  size_t fTunedUniverse; ///< universe the single GReWeight is tuned to
+
   std::string fGenieModuleLabel;
   std::string fTuneName;
 
@@ -246,6 +256,8 @@ private:
 
   void SetupWeightCalculators(genie::rew::GReWeight& rw,
         const std::map<std::string, int>& modes_to_use);
+
+  void TuneUniverse(genie::rew::GReWeight& rw, size_t univ);
  
   bool fQuietMode;//quiet mode
 
@@ -357,6 +369,8 @@ void GenieWeightCalc::Configure(fhicl::ParameterSet const& p,
 
   std::string mode = pset.get<std::string>("mode");
 
+  fSingleReweight = pset.get<bool>("single_reweight", false);
+
   int num_universes = 1; //for "central_value" or "default" mode
 
   std::string array_name_for_exception;
@@ -433,21 +447,10 @@ void GenieWeightCalc::Configure(fhicl::ParameterSet const& p,
   fParameterSet.Configure(GetFullName(), mode, num_universes);
   fParameterSet.Sample(engine);
 
-  //Initialize  genie::rew::GReWeight's
-  reweightVector.resize( num_universes );// Reconfigure this later in this function.
-  std::cout << GetFullName() << ": Initialize WeightCalculators with "<<num_universes<<" univeres."<<std::endl;
-
-  // Initialize weight calculators for all universes;
-  for ( auto& rwght : reweightVector ){ this->SetupWeightCalculators( rwght, modes_to_use );}
-
-  // Set up parameters
-  for ( size_t univ = 0; univ < reweightVector.size(); ++univ ) {//loop over universes
-
-    auto& rwght = reweightVector.at( univ );
-    genie::rew::GSystSet& syst = rwght.Systematics();
-
-    rwght.Reconfigure();//Redundant, but it avoids "cushion error":
-    //1638551728 FATAL ReW : [n] <GReWeightINukeParams.cxx::AddCushionTerms (583)> : There must be at least one cushion term (0 were set)
+  // Knob values for all universes
+  fUniverseKnobs.assign( num_universes, {} );
+  fUniverseIncludesMaCCQE.assign( num_universes, false );
+  for ( int univ = 0; univ < num_universes; ++univ ) {//loop over universes
     //loop over parameters;
     for (auto const& it : fParameterSet.fParameterMap) {//loop over knobs
       //member of std::map<EventWeightParameter, std::vector<float> >
@@ -467,7 +470,8 @@ void GenieWeightCalc::Configure(fhicl::ParameterSet const& p,
       }
 
       double twk_dial_value = it.second[univ]+cv_shift;
-      syst.Set( knob, twk_dial_value ); //Assign knob with new values based on variation
+      fUniverseKnobs[univ].emplace_back( knob, twk_dial_value );
+      if ( knob == kXSecTwkDial_MaCCQE ) fUniverseIncludesMaCCQE[univ] = true;
 
       std::cout << GetFullName() << ": univ "<<univ<<" "<<genie::rew::GSyst::AsString( knob )<<" Knob value: "<<twk_dial_value<<std::endl;
 
@@ -478,9 +482,36 @@ void GenieWeightCalc::Configure(fhicl::ParameterSet const& p,
       }
 
     }//next knob
-    rwght.Reconfigure();//Apply all set knobs, i.e. use the updated syst.
+  }//next universe
+
+  //Initialize  genie::rew::GReWeight's
+  reweightVector.resize( fSingleReweight ? 1 : num_universes );// Reconfigure this later in this function.
+  std::cout << GetFullName() << ": Initialize " << reweightVector.size()
+    << " WeightCalculators for "<<num_universes<<" univeres."<<std::endl;
+
+  // Initialize weight calculators for all universes;
+  for ( auto& rwght : reweightVector ){ this->SetupWeightCalculators( rwght, modes_to_use );}
+
+  // Set up parameters
+  for ( size_t univ = 0; univ < reweightVector.size(); ++univ ) {//loop over universes
+
+    auto& rwght = reweightVector.at( univ );
+
+    rwght.Reconfigure();//Redundant, but it avoids "cushion error":
+    //1638551728 FATAL ReW : [n] <GReWeightINukeParams.cxx::AddCushionTerms (583)> : There must be at least one cushion term (0 were set)
+    this->TuneUniverse( rwght, univ );
     rwght.Print();
   }//next universe
+  fTunedUniverse = 0;
+}
+
+
+void GenieWeightCalc::TuneUniverse(genie::rew::GReWeight& rw, size_t univ) {
+  genie::rew::GSystSet& syst = rw.Systematics();
+  for ( auto const& [knob, twk_dial_value] : fUniverseKnobs.at( univ ) ) {
+    syst.Set( knob, twk_dial_value ); //Assign knob with new values based on variation
+  }
+  rw.Reconfigure();//Apply all set knobs, i.e. use the updated syst.
 }
 
 //Keng:
@@ -502,7 +533,7 @@ std::vector<float> GenieWeightCalc::GetWeight(art::Event& e, size_t inu) {
     std::vector< art::Ptr<simb::GTruth > > glist;
     art::fill_ptr_vector( glist, gTruthHandle );
 
-    size_t num_knobs = reweightVector.size();
+    size_t num_knobs = fUniverseKnobs.size();
 
     // Calculate weight(s) here
     std::vector< float > weights( num_knobs );
@@ -543,15 +574,19 @@ std::vector<float> GenieWeightCalc::GetWeight(art::Event& e, size_t inu) {
     for (size_t k = 0u; k < num_knobs; ++k ) {//one "knob" for one universe;
       //Add exception to avoid "FATAL KineLimits", 
       //  see https://github.com/GENIE-MC/Reweight/issues/12
-      std::vector< genie::rew::GSyst_t > ak = reweightVector.at( k ).Systematics().AllIncluded();//all konbs used
 
       //NOTE: this line is to skip reweighting stange-CCQE events 
       //Among 7500 events, 207 of them are strange events; ~3%
-      if(glist[inu]->fIsStrange && std::find(ak.begin(), ak.end(),  kXSecTwkDial_MaCCQE) != ak.end()){
+      if(glist[inu]->fIsStrange && fUniverseIncludesMaCCQE[k]){
         weights[k] = 1;
       } else{
-        weights[k] = reweightVector.at( k ).CalcWeight( *genie_event );
-        reweightVector.at(k).Print();
+        genie::rew::GReWeight& rwght = reweightVector.at( fSingleReweight ? 0 : k );
+        if ( fSingleReweight && fTunedUniverse != k ) {
+          this->TuneUniverse( rwght, k );
+          fTunedUniverse = k;
+        }
+        weights[k] = rwght.CalcWeight( *genie_event );
+        if ( !fQuietMode ) rwght.Print();
       }
 //  std::cout<<"CHECK "<<k<<" universe weight "<<weights[k]<<std::endl;
     }
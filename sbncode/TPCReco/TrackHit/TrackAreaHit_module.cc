@@ -37,12 +37,31 @@
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "larsim/Simulation/LArG4Parameters.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace sbn {
   class TrackAreaHit;
 }
 
+namespace {
+  // Dense channel -> collection index table, holding the first object on each channel (-1 if none)
+  template<class T>
+  std::vector<int> MakeChannelIndex(const std::vector<art::Ptr<T>> &objs) {
+    std::vector<int> index;
+    for (unsigned i = 0; i < objs.size(); i++) {
+      raw::ChannelID_t channel = objs[i]->Channel();
+      if (channel >= index.size()) index.resize(channel+1, -1);
+      if (index[channel] < 0) index[channel] = (int)i;
+    }
+    return index;
+  }
+
+  int LookupChannel(const std::vector<int> &index, raw::ChannelID_t channel) {
+    return (channel < index.size()) ? index[channel] : -1;
+  }
+}
+
 
 class sbn::TrackAreaHit : public art::EDProducer {
 public:
@@ -123,39 +142,40 @@ recob::Hit sbn::TrackAreaHit::MakeHit(const recob::Wire &wire, const geo::WireID
   //std::cout << "Hit view: " << hitView << " " << " sigType: " << hitSignalType << " wireID: " << wireID << std::endl;
   
   const recob::Wire::RegionsOfInterest_t &ROI = wire.SignalROI();
-  for (lar::sparse_vector<float>::datarange_t range: ROI.get_ranges()) {
+  const auto &ranges = ROI.get_ranges();
+  // the ranges are sorted and disjoint: skip straight to the first one that can overlap the window
+  auto first = std::lower_bound(ranges.begin(), ranges.end(), startTick,
+    [](const lar::sparse_vector<float>::datarange_t &range, raw::TDCtick_t tick) { return (raw::TDCtick_t)range.end_index() < tick; });
+  for (auto it = first; it != ranges.end(); it++) {
+    const lar::sparse_vector<float>::datarange_t &range = *it;
     raw::TDCtick_t roiStart = range.begin_index();
     raw::TDCtick_t roiEnd = range.end_index();
     
     //std::cout << "Window from: " << startTick << " to " << endTick << std::endl;
     //std::cout << "ROI from: " << roiStart << " to " << roiEnd << std::endl;
-    // check for overlap
-    if (roiStart <= endTick && startTick <= roiEnd) {
-      // shrink the ROI to the integration window
-      if (roiStart < startTick && startTick <= roiEnd) range.move_head(startTick);
-      if (roiEnd > endTick && endTick >= roiStart) range.move_tail(endTick);
-
-      // integrate
-      for (float v: range) {
-        hitSumADC += v;
-        hitIntegral += v;
-      }
+    // no later ROI can overlap
+    if (roiStart > endTick) break;
 
-      // update start and end time
-      raw::TDCtick_t thisStart = std::max(roiStart, startTick);
-      raw::TDCtick_t thisEnd = std::min(roiEnd, endTick);
-      
-      //std::cout << "Integrating from " << thisStart << " to " << thisEnd << std::endl;
-      //std::cout << "Total integral: " << hitIntegral << std::endl;
-      
-      if (!setstartTick || thisStart < hitStartTick) {
-        hitStartTick = thisStart;
-        setstartTick = true;
-      }
-      if (!setendTick || thisEnd > hitEndTick) {
-        hitEndTick = thisEnd;
-        setendTick = true;
-      }
+    // the ROI overlaps: integrate the part inside the window, in place
+    raw::TDCtick_t thisStart = std::max(roiStart, startTick);
+    raw::TDCtick_t thisEnd = std::min(roiEnd, endTick);
+
+    for (auto v = range.begin() + (thisStart - roiStart); v < range.begin() + (thisEnd - roiStart); v++) {
+      hitSumADC += *v;
+      hitIntegral += *v;
+    }
+
+    // update start and end time
+    //std::cout << "Integrating from " << thisStart << " to " << thisEnd << std::endl;
+    //std::cout << "Total integral: " << hitIntegral << std::endl;
+    
+    if (!setstartTick || thisStart < hitStartTick) {
+      hitStartTick = thisStart;
+      setstartTick = true;
+    }
+    if (!setendTick || thisEnd > hitEndTick) {
+      hitEndTick = thisEnd;
+      setendTick = true;
     }
   }
 
@@ -278,6 +298,9 @@ void sbn::TrackAreaHit::produce(art::Event& e)
     }
   }
 
+  // channel -> index into wires/digits, built once per event
+  std::vector<int> channelIndex = fUseWires ? MakeChannelIndex(wires) : MakeChannelIndex(digits);
+
   art::FindManyP<anab::T0> fmT0(tracks, e, fT0Label);
 
   const geo::GeometryCore *geo = lar::providerFrom<geo::Geometry>();
@@ -429,13 +452,7 @@ void sbn::TrackAreaHit::produce(art::Event& e)
           int assoc_ind;
           if (fUseWires) {
             // First find the corresponding recob::Wire
-            int wire_ind = -1;
-            for (unsigned i_rwire = 0; i_rwire < wires.size(); i_rwire++) {
-              if (channel == wires[i_rwire]->Channel()) {
-                wire_ind = (int)i_rwire;
-                break;
-              }
-            }
+            int wire_ind = LookupChannel(channelIndex, channel);
             assoc_ind = wire_ind;
 
             // make the hit
@@ -443,13 +460,7 @@ void sbn::TrackAreaHit::produce(art::Event& e)
           }
           else {
             // Find the digits
-            int digit_ind = -1;
-            for (unsigned i_digit = 0; i_digit < digits.size(); i_digit++) {
-              if (channel == digits[i_digit]->Channel()) {
-                digit_ind = (int)i_digit;
-                break;
-              }
-            }
+            int digit_ind = LookupChannel(channelIndex, channel);
             assoc_ind = digit_ind;
 
             // Make the hit